@@ -0,0 +1,153 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+// Drawing the same sprites every frame, first when every image has
+// its own texture and then when all of the images are packed into
+// one atlas, in immediate and in batched mode, and printing how many
+// sprites per second each one of them reached and how many draw
+// calls the batch needed.
+//
+// Usage: ./atlas_benchmark [sprites] [images] [frames]
+
+static int sprites = 10000;
+static int images  = 256;
+static int frames  = 100;
+
+static constexpr unsigned int IMAGE_SIZE = 32;
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    enum Source { Individual, Atlas, SourceCount };
+
+    gfx::TextureAtlas atlas;
+    std::vector<unsigned int> textures;
+    std::vector<gfx::Sprite> individual_sprites;
+    std::vector<gfx::Sprite> atlas_sprites;
+
+    int source = Individual;
+    int frame = 0;
+    size_t commands = 0;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT),
+          gfx::GLFunctions(get_renderer())
+    {
+        std::mt19937 mt(1234);
+        std::uniform_int_distribution<int> x_dist(0, WIDTH);
+        std::uniform_int_distribution<int> y_dist(0, HEIGHT);
+        std::uniform_int_distribution<int> color_dist(0, 255);
+
+        std::vector<gfx::TextureAtlas::Region> individual_regions;
+        std::vector<gfx::TextureAtlas::Region> atlas_regions;
+        std::vector<unsigned char> pixels(IMAGE_SIZE * IMAGE_SIZE * 4);
+
+        for(int i = 0; i < images; i++)
+        {
+            for(auto& p : pixels)
+                p = static_cast<unsigned char>(color_dist(mt));
+
+            // A texture for every image
+            unsigned int texture;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, IMAGE_SIZE, IMAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            textures.push_back(texture);
+
+            gfx::TextureAtlas::Region region;
+            region.texture  = texture;
+            region.position = {0, 0};
+            region.size     = {IMAGE_SIZE, IMAGE_SIZE};
+            region.uv_min   = {0.f, 0.f};
+            region.uv_max   = {1.f, 1.f};
+            individual_regions.push_back(region);
+
+            // The same image in the atlas
+            atlas_regions.push_back(atlas.add(pixels.data(), IMAGE_SIZE, IMAGE_SIZE));
+        }
+
+        // Every sprite is using the next image, so the
+        // textures are changing all of the time
+        individual_sprites.resize(sprites);
+        atlas_sprites.resize(sprites);
+        for(int i = 0; i < sprites; i++)
+        {
+            const gfx::VectorI position(x_dist(mt), y_dist(mt));
+            individual_sprites[i].create(individual_regions[i % images], 16, 16, position.x, position.y);
+            atlas_sprites[i].create(atlas_regions[i % images], 16, 16, position.x, position.y);
+        }
+
+        std::cout << images << " images in " << atlas.get_page_count() << " atlas pages" << std::endl;
+        set_mode(Mode::Immediate);
+    }
+
+    ~Win()
+    {
+        glDeleteTextures(textures.size(), textures.data());
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+            begin = std::chrono::steady_clock::now();
+
+        clear();
+        start();
+
+        for(auto& s : source == Individual ? individual_sprites : atlas_sprites)
+            draw(s);
+
+        // The amount of draw calls that flush is going to make
+        commands = m_batch.command_count();
+
+        swap_buffers();
+
+        if(++frame < frames)
+            return;
+
+        // Making sure the GPU is done before stopping the clock
+        glFinish();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::cout << (get_mode() == Mode::Immediate ? "immediate " : "batched   ")
+                  << (source == Individual ? "individual" : "atlas     ") << ": "
+                  << (sprites * static_cast<double>(frames)) / elapsed.count() << " sprites/sec";
+        if(get_mode() == Mode::Batched)
+            std::cout << ", " << commands << " draw calls";
+        std::cout << std::endl;
+
+        // Next path or next source
+        frame = 0;
+        if(get_mode() == Mode::Immediate)
+            set_mode(Mode::Batched);
+        else
+        {
+            set_mode(Mode::Immediate);
+            if(++source == SourceCount)
+                close();
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) sprites = std::stoi(argv[1]);
+    if(argc > 2) images  = std::stoi(argv[2]);
+    if(argc > 3) frames  = std::stoi(argv[3]);
+
+    gfx::construct_windows<Win>();
+}
@@ -0,0 +1,158 @@
+#include "../src/include/gfx"
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+
+// Drawing the same frame with the headless OpenGL backend and with the
+// software rasterizer, and failing if they are not the same. The edges
+// of a shape may be a pixel off between them, so a pixel matches if the
+// other frame has a close enough color in the 3x3 pixels around it.
+//
+// Usage: ./backend_compare [image]
+// Returns 0 if they match, 1 if they don't and 77 if there's no EGL
+
+// Maximum difference of every channel
+static constexpr int TOLERANCE = 8;
+
+static constexpr int WIDTH  = 320;
+static constexpr int HEIGHT = 240;
+
+static std::string image_path = "../examples/cubes.png";
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+public:
+    explicit Win(Backend backend)
+        : gfx::Renderer(WIDTH, HEIGHT, backend),
+          gfx::GLFunctions(get_renderer(), Mode::Batched) {}
+
+    void on_update() override
+    {
+        clear(gfx::Color(30, 30, 40));
+        start();
+
+        // Rectangles, filled and outlined
+        for(int i = 0; i < 6; i++)
+        {
+            gfx::Rectangle rect;
+            rect.set_position(10 + i * 50, 10);
+            rect.set_size(40, 30 + i * 4);
+            rect.set_color(gfx::Color(40 * i, 255 - 40 * i, 120));
+            rect.set_fill(i % 2 == 0);
+            draw(rect);
+        }
+
+        // Circles, the last one is scaled
+        for(int i = 0; i < 4; i++)
+        {
+            gfx::Circle circle;
+            circle.set_position(40 + i * 70, 110);
+            circle.set_radius(12.f + i * 6);
+            circle.set_color(gfx::Color(255, 60 * i, 60));
+            circle.set_fill(i != 2);
+            if(i == 3)
+                circle.set_scale(1.5f, 0.75f);
+            draw(circle);
+        }
+
+        // A shape with a color for every vertex and a rotated rectangle,
+        // the shape has no defaults so everything is set
+        gfx::Shape shape;
+        shape.add_vertex({
+            gfx::Vertex({20, 230},  gfx::Color(90, 160, 255)),
+            gfx::Vertex({60, 160},  gfx::Color(255, 160, 90)),
+            gfx::Vertex({110, 180}, gfx::Color(160, 255, 90)),
+            gfx::Vertex({100, 225}, gfx::Color(90, 160, 255))
+        });
+        shape.set_fill(true);
+        shape.set_connection(true);
+        draw(shape);
+
+        gfx::Rectangle rotated;
+        rotated.set_position(140, 170);
+        rotated.set_size(50, 30);
+        rotated.set_color(gfx::Color(200, 200, 40));
+        rotated.set_rotation(30);
+        draw(rotated);
+
+        // Sprites, stretched and at their own size
+        gfx::Sprite sprite(image_path, 64, 48, 220, 160);
+        draw(sprite);
+        sprite.set_position(140, 60);
+        sprite.set_size(32, 32);
+        draw(sprite);
+
+        flush();
+        swap_buffers();
+    }
+};
+
+static std::vector<gfx::Color> render(gfx::Renderer::Backend backend, bool& software)
+{
+    Win win(backend);
+    software = win.get_backend() == gfx::Renderer::Backend::Software;
+
+    win.on_update();
+    return win.get_frame();
+}
+
+// True if a pixel around x, y of the other frame is close to the color
+static bool matches(const std::vector<gfx::Color>& frame, int x, int y, const gfx::Color& color)
+{
+    for(int dy = -1; dy <= 1; dy++)
+    for(int dx = -1; dx <= 1; dx++)
+    {
+        const int nx = x + dx;
+        const int ny = y + dy;
+        if(nx < 0 || ny < 0 || nx >= WIDTH || ny >= HEIGHT)
+            continue;
+
+        const gfx::Color& other = frame[ny * WIDTH + nx];
+        if(std::abs(other.r - color.r) <= TOLERANCE &&
+           std::abs(other.g - color.g) <= TOLERANCE &&
+           std::abs(other.b - color.b) <= TOLERANCE)
+            return true;
+    }
+
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1)
+        image_path = argv[1];
+
+    bool software = false;
+    const std::vector<gfx::Color> opengl = render(gfx::Renderer::Backend::Headless, software);
+    if(software)
+    {
+        std::cout << "no headless OpenGL, nothing to compare" << std::endl;
+        return 77;
+    }
+
+    const std::vector<gfx::Color> rasterized = render(gfx::Renderer::Backend::HeadlessSoftware, software);
+
+    if(opengl.size() != rasterized.size() || opengl.empty())
+    {
+        std::cout << "the frames were not captured" << std::endl;
+        return 1;
+    }
+
+    // Both ways, so a shape that is missing from one of them is found
+    size_t different = 0;
+    for(int y = 0; y < HEIGHT; y++)
+    for(int x = 0; x < WIDTH; x++)
+    {
+        if(!matches(rasterized, x, y, opengl[y * WIDTH + x]) || !matches(opengl, x, y, rasterized[y * WIDTH + x]))
+        {
+            if(different++ < 10)
+                std::printf("different at %d, %d\n", x, y);
+        }
+    }
+
+    std::printf("%zu of %d pixels are different (tolerance %d)\n", different, WIDTH * HEIGHT, TOLERANCE);
+    return different == 0 ? 0 : 1;
+}
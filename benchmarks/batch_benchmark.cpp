@@ -0,0 +1,134 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+// Drawing the same amount of rectangles, circles and sprites
+// every frame, first in immediate mode and then in batched mode,
+// and printing how many draws per second each one of them reached.
+//
+// Usage: ./batch_benchmark [objects] [frames] [image]
+
+static int         objects     = 20000;
+static int         frames      = 100;
+static std::string sprite_path = "../examples/cubes.png";
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    enum Workload { Rectangles, Circles, Sprites, WorkloadCount };
+
+    std::vector<gfx::Rectangle> rects;
+    std::vector<gfx::Circle> circles;
+    std::vector<gfx::VectorI> sprite_positions;
+    gfx::Sprite spr;
+
+    int workload = Rectangles;
+    int frame = 0;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT),
+          gfx::GLFunctions(get_renderer())
+    {
+        std::mt19937 mt(1234);
+        std::uniform_int_distribution<int> x_dist(0, WIDTH);
+        std::uniform_int_distribution<int> y_dist(0, HEIGHT);
+        std::uniform_int_distribution<int> size_dist(2, 30);
+        std::uniform_int_distribution<int> color_dist(0, 255);
+
+        for(int i = 0; i < objects; i++)
+        {
+            gfx::Color color(color_dist(mt), color_dist(mt), color_dist(mt));
+
+            gfx::Rectangle rect;
+            rect.set_position(x_dist(mt), y_dist(mt));
+            rect.set_size(size_dist(mt), size_dist(mt));
+            rect.set_color(color);
+            rect.set_fill(i % 2 == 0);
+            rects.push_back(rect);
+
+            gfx::Circle circle;
+            circle.set_position(x_dist(mt), y_dist(mt));
+            circle.set_radius(size_dist(mt));
+            circle.set_color(color);
+            circle.set_fill(i % 2 == 0);
+            circles.push_back(circle);
+
+            sprite_positions.push_back({x_dist(mt), y_dist(mt)});
+        }
+
+        spr.create(sprite_path, 16, 16, 0, 0);
+        set_mode(Mode::Immediate);
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+            begin = std::chrono::steady_clock::now();
+
+        clear();
+        start();
+
+        switch(workload)
+        {
+        case Rectangles:
+            for(auto& r : rects)
+                draw(r);
+            break;
+        case Circles:
+            for(auto& c : circles)
+                draw(c);
+            break;
+        case Sprites:
+            for(auto& p : sprite_positions)
+            {
+                spr.set_position(p);
+                draw(spr);
+            }
+            break;
+        }
+
+        swap_buffers();
+
+        if(++frame < frames)
+            return;
+
+        // Making sure the GPU is done before stopping the clock
+        glFinish();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        static const char* names[] = { "rectangles", "circles", "sprites" };
+        std::cout << (get_mode() == Mode::Immediate ? "immediate " : "batched   ")
+                  << names[workload] << ": "
+                  << (objects * static_cast<double>(frames)) / elapsed.count() << " draws/sec, "
+                  << frames / elapsed.count() << " frames/sec" << std::endl;
+
+        // Next path or next workload
+        frame = 0;
+        if(get_mode() == Mode::Immediate)
+            set_mode(Mode::Batched);
+        else
+        {
+            set_mode(Mode::Immediate);
+            if(++workload == WorkloadCount)
+                close();
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) objects     = std::stoi(argv[1]);
+    if(argc > 2) frames      = std::stoi(argv[2]);
+    if(argc > 3) sprite_path = argv[3];
+
+    gfx::construct_windows<Win>();
+}
\ No newline at end of file
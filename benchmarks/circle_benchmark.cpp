@@ -0,0 +1,124 @@
+#include "../src/include/gfx"
+#include "../src/include/batch.hpp"
+#include "../src/include/utils/tessellation.hpp"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+// Tessellating circles into a batch on the CPU (no window is needed),
+// for every radius bucket, and printing how many circles per second
+// were tessellated and how many vertices every circle needed.
+// The "fixed" line is the old tessellation, 20 filled segments or
+// 100 outlined segments with cosf / sinf for every point.
+// The "unchanged" line is drawing the same circles again without
+// changing them, so the vertices are copied from the cache.
+// Half of the circles are filled and half are outlined.
+//
+// Usage: ./circle_benchmark [circles] [iterations]
+
+static int circles    = 50000;
+static int iterations = 20;
+
+// The tessellation before the cache, cosf / sinf for every point
+// and a fixed amount of segments, written into the same vertices
+static void fixed_tessellation(const gfx::Circle& circle, const gfx::Matrix& matrix, std::vector<gfx::BatchVertex>& out)
+{
+    const bool fill = circle.get_fill();
+    const int segments = fill ? 20 : 100;
+    const gfx::VectorI pos = circle.get_position();
+    const gfx::Color color = circle.get_color();
+
+    auto push = [&](float x, float y) {
+        const gfx::VectorF p = matrix.apply(x, y);
+        out.push_back({ p.x, p.y, 0.f, 0.f, color });
+    };
+
+    for (int i = 0; i < segments; i++)
+    {
+        const float from = gfx::PI2 * i / segments;
+        const float to   = gfx::PI2 * (i + 1) / segments;
+
+        if(fill)
+            push(pos.x, pos.y);
+        push(pos.x + circle.get_radius() * cosf(from), pos.y + circle.get_radius() * sinf(from));
+        push(pos.x + circle.get_radius() * cosf(to),   pos.y + circle.get_radius() * sinf(to));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) circles    = std::stoi(argv[1]);
+    if(argc > 2) iterations = std::stoi(argv[2]);
+
+    const float buckets[][2] = {
+        { 1.f, 2.f }, { 2.f, 4.f }, { 4.f, 8.f }, { 8.f, 16.f },
+        { 16.f, 32.f }, { 32.f, 64.f }, { 64.f, 128.f }, { 128.f, 256.f }
+    };
+
+    std::mt19937 mt(1234);
+    std::uniform_int_distribution<int> pos_dist(0, 800);
+
+    for(const auto& bucket : buckets)
+    {
+        std::uniform_real_distribution<float> radius_dist(bucket[0], bucket[1]);
+
+        std::vector<gfx::Circle> shapes(circles);
+        for(int i = 0; i < circles; i++)
+        {
+            shapes[i].set_position(pos_dist(mt), pos_dist(mt));
+            shapes[i].set_radius(radius_dist(mt));
+            shapes[i].set_fill(i % 2 == 0);
+        }
+
+        // Adaptive segments from the cached tables, every circle
+        // is changed so it has to be tessellated again
+        gfx::Batch batch;
+        size_t vertices = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            batch.clear();
+            for(auto& c : shapes)
+            {
+                c.set_radius(c.get_radius());
+                batch.add(c, gfx::Matrix());
+            }
+            vertices = batch.vertex_count();
+        }
+        std::chrono::duration<double> cached = std::chrono::steady_clock::now() - begin;
+
+        // Nothing was changed since the last loop
+        begin = std::chrono::steady_clock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            batch.clear();
+            for(const auto& c : shapes)
+                batch.add(c, gfx::Matrix());
+        }
+        std::chrono::duration<double> unchanged = std::chrono::steady_clock::now() - begin;
+
+        // The fixed tessellation
+        std::vector<gfx::BatchVertex> fixed_stream;
+        size_t fixed_vertices = 0;
+
+        begin = std::chrono::steady_clock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            fixed_stream.clear();
+            for(const auto& c : shapes)
+                fixed_tessellation(c, gfx::Matrix(), fixed_stream);
+            fixed_vertices = fixed_stream.size();
+        }
+        std::chrono::duration<double> fixed = std::chrono::steady_clock::now() - begin;
+
+        const double total = static_cast<double>(circles) * iterations;
+        std::cout << "radius " << bucket[0] << "-" << bucket[1] << ":" << std::endl
+                  << "    cached:    " << total / cached.count() << " circles/sec, "
+                  << static_cast<double>(vertices) / circles << " vertices/circle" << std::endl
+                  << "    unchanged: " << total / unchanged.count() << " circles/sec" << std::endl
+                  << "    fixed:     " << total / fixed.count() << " circles/sec, "
+                  << static_cast<double>(fixed_vertices) / circles << " vertices/circle" << std::endl;
+    }
+}
@@ -0,0 +1,66 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+// Converting arrays of colors into GL floats and back (no window
+// is needed), one channel at a time with rgba_to_gl and with the
+// vectorized colors_to_gl / gl_to_colors, and printing how many
+// colors per second were converted.
+//
+// Usage: ./color_benchmark [colors] [iterations]
+
+static int colors     = 1 << 20;
+static int iterations = 50;
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) colors     = std::stoi(argv[1]);
+    if(argc > 2) iterations = std::stoi(argv[2]);
+
+    std::mt19937 mt(1234);
+    std::uniform_int_distribution<int> channel(0, 255);
+
+    std::vector<gfx::Color> input(colors);
+    for(auto& color : input)
+        color = gfx::Color(channel(mt), channel(mt), channel(mt), channel(mt));
+
+    std::vector<float> floats(colors * 4);
+    std::vector<gfx::Color> output(colors);
+
+    // One channel at a time
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++)
+    {
+        for(int j = 0; j < colors; j++)
+        {
+            floats[j * 4 + 0] = gfx::rgba_to_gl(input[j].r);
+            floats[j * 4 + 1] = gfx::rgba_to_gl(input[j].g);
+            floats[j * 4 + 2] = gfx::rgba_to_gl(input[j].b);
+            floats[j * 4 + 3] = gfx::rgba_to_gl(input[j].a);
+        }
+    }
+    std::chrono::duration<double> scalar = std::chrono::steady_clock::now() - begin;
+
+    // Vectorized, both ways
+    begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++)
+        gfx::colors_to_gl(input.data(), floats.data(), input.size());
+    std::chrono::duration<double> to_gl = std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++)
+        gfx::gl_to_colors(floats.data(), output.data(), output.size());
+    std::chrono::duration<double> from_gl = std::chrono::steady_clock::now() - begin;
+
+    // Converting back and forth has to give the same colors
+    const bool same = input == output;
+
+    const double total = static_cast<double>(colors) * iterations;
+    std::cout << "sizeof(Color) = " << sizeof(gfx::Color) << " bytes" << std::endl
+              << "rgba_to_gl:   " << total / scalar.count()  << " colors/sec" << std::endl
+              << "colors_to_gl: " << total / to_gl.count()   << " colors/sec" << std::endl
+              << "gl_to_colors: " << total / from_gl.count() << " colors/sec" << std::endl
+              << "round trip:   " << (same ? "exact" : "different") << std::endl;
+}
@@ -0,0 +1,128 @@
+#include "../src/include/gfx"
+#include "../src/include/utils/thread_pool.hpp"
+#include <chrono>
+#include <future>
+#include <string>
+
+// Drawing the same circles in a headless window, once with draw on
+// the thread of the window and once recorded into a draw list for
+// every worker and submitted by the thread of the window. The circles
+// are moving every frame so they are tessellated again every frame.
+//
+// Usage: ./draw_list_benchmark [circles] [frames] [workers]
+
+static int    circle_count = 100000;
+static int    frames       = 50;
+static size_t workers      = gfx::ThreadPool::hardware_workers();
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    std::vector<gfx::Circle> circles;
+    std::vector<gfx::DrawList> lists;
+    gfx::ThreadPool pool;
+
+    int frame = 0;
+    bool recording = false;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, Backend::Headless),
+          gfx::GLFunctions(get_renderer(), Mode::Batched),
+          lists(workers),
+          pool(workers)
+    {
+        for(int i = 0; i < circle_count; i++)
+        {
+            gfx::Circle circle;
+            circle.set_radius(static_cast<float>(2 + i % 8));
+            circle.set_color(gfx::Color(i % 256, 100, 255 - i % 256));
+            circle.set_fill(true);
+            circles.push_back(circle);
+        }
+
+        set_capture(false);
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+            begin = std::chrono::steady_clock::now();
+
+        clear();
+        start();
+
+        if(recording)
+            record();
+        else
+        {
+            for(int i = 0; i < circle_count; i++)
+            {
+                move(i);
+                draw(circles[i]);
+            }
+        }
+
+        swap_buffers();
+        glFinish();
+
+        if(++frame < frames)
+            return;
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << (recording ? "draw lists on " + std::to_string(workers) + " workers: " : "draw on the window thread: ")
+                  << elapsed.count() / frames << " ms/frame" << std::endl;
+
+        frame = 0;
+        if(recording)
+            close();
+        recording = true;
+    }
+
+private:
+    void move(int i) {
+        circles[i].set_position((i * 37 + frame * 3) % WIDTH, (i * 91 + frame) % HEIGHT);
+    }
+
+    // Every worker is recording a range of the circles
+    void record()
+    {
+        std::vector<std::future<void>> done;
+        const int per_list = (circle_count + static_cast<int>(workers) - 1) / static_cast<int>(workers);
+
+        for(size_t w = 0; w < workers; w++)
+        {
+            done.push_back(pool.submit([this, w, per_list]() {
+                gfx::DrawList& list = lists[w];
+                list.clear();
+
+                const int end = std::min(circle_count, static_cast<int>(w + 1) * per_list);
+                for(int i = static_cast<int>(w) * per_list; i < end; i++)
+                {
+                    move(i);
+                    list.add(circles[i]);
+                }
+            }));
+        }
+
+        for(auto& future : done)
+            future.get();
+
+        submit(lists);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) circle_count = std::stoi(argv[1]);
+    if(argc > 2) frames       = std::stoi(argv[2]);
+    if(argc > 3) workers      = std::stoul(argv[3]);
+
+    gfx::construct_windows<Win>();
+}
@@ -0,0 +1,407 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+// Running the same workloads for a fixed amount of frames and
+// printing the results as JSON: frames per second, draws per
+// second and the 50th and 99th percentile of the frame times.
+// A draw is whatever a workload is doing many times in a frame,
+// a shape, a pixel that was set or a keyboard and mouse query.
+//
+// The results are only comparable with the same renderer, so
+// run it without a GPU, on a virtual X server with Mesa llvmpipe
+// and without vsync:
+//   xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1 vblank_mode=0 ./gfx_bench
+// or without an X server at all with --headless.
+//
+// Usage: ./gfx_bench [--frames N] [--objects N] [--immediate]
+//                    [--headless | --software] [--image path]
+//                    [--output results.json]
+//                    [--baseline baseline.json] [--threshold percent]
+//
+// With a baseline, every workload that is slower by more than the
+// threshold (10% by default) is a regression and the exit code is 1.
+
+static int         frames        = 200;
+static int         warmup        = 10;
+static int         objects       = 2000;
+static bool        immediate     = false;
+static std::string sprite_path   = "../examples/cubes.png";
+static std::string output_path;
+static std::string baseline_path;
+static double      threshold     = 10.0;
+
+static gfx::Renderer::Backend backend = gfx::Renderer::Backend::OpenGL;
+
+// The results of a single workload
+struct Result
+{
+    std::string name;
+    int draws_per_frame;
+    double fps;
+    double draws_per_sec;
+    double p50_ms;
+    double p99_ms;
+};
+
+static std::vector<Result> results;
+static std::string renderer_name;
+
+// ------------------------------------------------------------ //
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    enum Workload
+    {
+        FilledRectangles,
+        OutlinedRectangles,
+        Circles,
+        Polylines,
+        Sprites,
+        SetPixel,
+        InputQueries,
+        WorkloadCount
+    };
+
+    std::vector<gfx::Rectangle> filled;
+    std::vector<gfx::Rectangle> outlined;
+    std::vector<gfx::Circle> circles;
+    std::vector<gfx::Shape> polylines;
+    std::vector<gfx::VectorI> sprite_positions;
+    gfx::Sprite spr;
+    gfx::Sprite canvas;
+
+    int workload = FilledRectangles;
+    int frame = 0;
+    std::vector<double> frame_times;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, backend),
+          gfx::GLFunctions(get_renderer(), immediate ? Mode::Immediate : Mode::Batched)
+    {
+        std::mt19937 mt(1234);
+        std::uniform_int_distribution<int> x_dist(0, WIDTH);
+        std::uniform_int_distribution<int> y_dist(0, HEIGHT);
+        std::uniform_int_distribution<int> size_dist(2, 30);
+        std::uniform_int_distribution<int> color_dist(0, 255);
+
+        for(int i = 0; i < objects; i++)
+        {
+            gfx::Color color(color_dist(mt), color_dist(mt), color_dist(mt));
+
+            gfx::Rectangle rect;
+            rect.set_position(x_dist(mt), y_dist(mt));
+            rect.set_size(size_dist(mt), size_dist(mt));
+            rect.set_color(color);
+            filled.push_back(rect);
+
+            rect.set_fill(false);
+            outlined.push_back(rect);
+
+            // Every radius from 2 to 64
+            gfx::Circle circle;
+            circle.set_position(x_dist(mt), y_dist(mt));
+            circle.set_radius(static_cast<float>(2 + i % 63));
+            circle.set_color(color);
+            circle.set_fill(i % 2 == 0);
+            circles.push_back(circle);
+
+            sprite_positions.push_back({x_dist(mt), y_dist(mt)});
+        }
+
+        // A few long polylines like the lines of a graph, every
+        // one of them is going from the left to the right
+        std::uniform_int_distribution<int> step_dist(-8, 8);
+        for(int i = 0; i < 10; i++)
+        {
+            gfx::Shape shape;
+            int y = y_dist(mt);
+            for(int j = 0; j < objects; j++)
+            {
+                y = std::min(std::max(y + step_dist(mt), 0), HEIGHT);
+                shape.add_vertex(gfx::Vertex(gfx::VectorI(j * WIDTH / objects, y), gfx::Color(color_dist(mt), 200, 255)));
+            }
+
+            shape.set_connection(false);
+            polylines.push_back(shape);
+        }
+
+        spr.create(sprite_path, 16, 16, 0, 0);
+        canvas.create(sprite_path, 256, 256, 0, 0);
+
+        // The frames are only read back if someone needs them
+        set_capture(false);
+
+        if(get_backend() == Backend::OpenGL)
+            renderer_name = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        else
+            renderer_name = "software rasterizer";
+    }
+
+    void on_update() override
+    {
+        if(frame == warmup)
+            frame_times.clear();
+
+        begin = std::chrono::steady_clock::now();
+
+        clear();
+        start();
+
+        const int draws = run(workload, frame);
+
+        swap_buffers();
+
+        // The frame is done only when the GPU is done with it
+        if(get_backend() == Backend::OpenGL)
+            glFinish();
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+        frame_times.push_back(elapsed.count());
+
+        if(++frame < warmup + frames)
+            return;
+
+        results.push_back(summarize(name_of(workload), draws));
+
+        frame = 0;
+        if(++workload == WorkloadCount)
+            close();
+    }
+
+private:
+    static const char* name_of(int workload)
+    {
+        static const char* names[] = {
+            "rectangles_filled", "rectangles_outlined", "circles", "polylines",
+            "sprites", "set_pixel", "input_queries"
+        };
+        return names[workload];
+    }
+
+    // Drawing a single frame of the workload, returns the amount of draws
+    int run(int workload, int frame)
+    {
+        switch(workload)
+        {
+        case FilledRectangles:
+            for(const auto& rect : filled)
+                draw(rect);
+            return static_cast<int>(filled.size());
+
+        case OutlinedRectangles:
+            for(const auto& rect : outlined)
+                draw(rect);
+            return static_cast<int>(outlined.size());
+
+        case Circles:
+            for(const auto& circle : circles)
+                draw(circle);
+            return static_cast<int>(circles.size());
+
+        case Polylines:
+            for(const auto& shape : polylines)
+                draw(shape);
+            return static_cast<int>(polylines.size());
+
+        case Sprites:
+            for(const auto& position : sprite_positions)
+            {
+                spr.set_position(position);
+                draw(spr);
+            }
+            return static_cast<int>(sprite_positions.size());
+
+        case SetPixel:
+        {
+            // Every pixel of the canvas, with a color that
+            // changes every frame so it's uploaded every frame
+            for(unsigned int y = 0; y < 256; y++)
+                for(unsigned int x = 0; x < 256; x++)
+                    canvas.set_pixel(x, y, gfx::Color(x, y, frame & 0xff));
+
+            draw(canvas);
+            return 256 * 256;
+        }
+
+        case InputQueries:
+        {
+            int pressed = 0;
+            for(int i = 0; i < objects; i++)
+            {
+                pressed += gfx::Keyboard::key_pressed(get_renderer(), gfx::Keyboard::Key::A);
+                pressed += gfx::Mouse::motion(get_renderer()).x > WIDTH;
+            }
+
+            // So the queries are never optimized away
+            if(pressed < 0)
+                std::cout << pressed << std::endl;
+            return objects * 2;
+        }
+        }
+
+        return 0;
+    }
+
+    Result summarize(const std::string& name, int draws) const
+    {
+        std::vector<double> sorted = frame_times;
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for(double time : sorted)
+            total += time;
+
+        // The nearest rank percentiles
+        auto percentile = [&sorted](double p) {
+            size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+            return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+        };
+
+        Result result;
+        result.name = name;
+        result.draws_per_frame = draws;
+        result.fps = sorted.size() / (total / 1000.0);
+        result.draws_per_sec = result.fps * draws;
+        result.p50_ms = percentile(50.0);
+        result.p99_ms = percentile(99.0);
+        return result;
+    }
+};
+
+// ------------------------------------------------------------ //
+
+static std::string to_json()
+{
+    const char* backends[] = { "opengl", "software", "headless", "headless_software" };
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"backend\": \"" << backends[static_cast<int>(backend)] << "\",\n"
+         << "  \"renderer\": \"" << renderer_name << "\",\n"
+         << "  \"mode\": \"" << (immediate ? "immediate" : "batched") << "\",\n"
+         << "  \"frames\": " << frames << ",\n"
+         << "  \"objects\": " << objects << ",\n"
+         << "  \"workloads\": [\n";
+
+    // Every workload is on its own line, so the
+    // baseline can be read one line at a time
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+
+        char line[512];
+        std::snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"draws_per_frame\": %d, \"fps\": %.3f, "
+            "\"draws_per_sec\": %.1f, \"p50_ms\": %.4f, \"p99_ms\": %.4f}%s\n",
+            r.name.c_str(), r.draws_per_frame, r.fps, r.draws_per_sec, r.p50_ms, r.p99_ms,
+            i + 1 < results.size() ? "," : "");
+        json << line;
+    }
+
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+// The number after a key of a workload line, or -1
+static double number_after(const std::string& line, const std::string& key)
+{
+    const size_t found = line.find("\"" + key + "\":");
+    if(found == std::string::npos)
+        return -1.0;
+
+    return std::atof(line.c_str() + found + key.size() + 3);
+}
+
+// Comparing the frames per second with the baseline,
+// returns false if any workload regressed
+static bool compare(const std::string& path)
+{
+    std::ifstream file(path);
+    if(!file)
+    {
+        std::cerr << "couldn't open the baseline " << path << std::endl;
+        return false;
+    }
+
+    bool passed = true;
+    std::string line;
+    while(std::getline(file, line))
+    {
+        const size_t name_begin = line.find("\"name\": \"");
+        if(name_begin == std::string::npos)
+            continue;
+
+        const size_t begin = name_begin + 9;
+        const std::string name = line.substr(begin, line.find('"', begin) - begin);
+        const double baseline_fps = number_after(line, "fps");
+
+        for(const auto& result : results)
+        {
+            if(result.name != name || baseline_fps <= 0.0)
+                continue;
+
+            const double change = (result.fps - baseline_fps) / baseline_fps * 100.0;
+            const bool regressed = change < -threshold;
+            passed = passed && !regressed;
+
+            char text[256];
+            std::snprintf(text, sizeof(text), "%-20s %10.2f fps -> %10.2f fps  %+7.2f%%%s",
+                name.c_str(), baseline_fps, result.fps, change, regressed ? "  REGRESSION" : "");
+            std::cerr << text << std::endl;
+        }
+    }
+
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if(arg == "--frames" && has_value)         frames = std::stoi(argv[++i]);
+        else if(arg == "--objects" && has_value)   objects = std::stoi(argv[++i]);
+        else if(arg == "--image" && has_value)     sprite_path = argv[++i];
+        else if(arg == "--output" && has_value)    output_path = argv[++i];
+        else if(arg == "--baseline" && has_value)  baseline_path = argv[++i];
+        else if(arg == "--threshold" && has_value) threshold = std::stod(argv[++i]);
+        else if(arg == "--immediate")              immediate = true;
+        else if(arg == "--headless")               backend = gfx::Renderer::Backend::Headless;
+        else if(arg == "--software")               backend = gfx::Renderer::Backend::HeadlessSoftware;
+        else
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    gfx::construct_windows<Win>();
+
+    const std::string json = to_json();
+    std::cout << json;
+
+    if(!output_path.empty())
+        std::ofstream(output_path) << json;
+
+    if(!baseline_path.empty() && !compare(baseline_path))
+        return 1;
+}
@@ -0,0 +1,74 @@
+#include "../src/include/gfx"
+#include "../src/include/image_loader.hpp"
+#include "../src/include/utils/thread_pool.hpp"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+
+// Decoding the same amount of images with 1 worker up to the given
+// amount of workers (no window is needed), and printing the wall time
+// it took until all of them were decoded. Every image is a copy of
+// the given image with a different path, so none of them are shared.
+// The "blocking" line is decoding all of them on the calling thread,
+// the way Sprite::create is doing it.
+//
+// Usage: ./image_loader_benchmark [images] [max workers] [image]
+
+static int         images      = 64;
+static int         max_workers = static_cast<int>(gfx::ThreadPool::hardware_workers());
+static std::string image_path  = "../examples/cubes.png";
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) images      = std::stoi(argv[1]);
+    if(argc > 2) max_workers = std::stoi(argv[2]);
+    if(argc > 3) image_path  = argv[3];
+
+    // Copying the image, so every path is decoded
+    std::ifstream source(image_path, std::ios::binary);
+    if(!source)
+    {
+        std::cout << "Couldn't open " << image_path << std::endl;
+        return 1;
+    }
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+
+    std::vector<std::string> paths;
+    for(int i = 0; i < images; i++)
+    {
+        paths.push_back("image_loader_benchmark_" + std::to_string(i) + ".png");
+        std::ofstream copy(paths.back(), std::ios::binary);
+        copy.write(bytes.data(), bytes.size());
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for(const auto& path : paths)
+        gfx::ImageLoader::decode(path);
+    std::chrono::duration<double> blocking = std::chrono::steady_clock::now() - begin;
+
+    std::cout << images << " images" << std::endl
+              << "blocking:   " << blocking.count() * 1000.0 << " ms" << std::endl;
+
+    for(int workers = 1; workers <= max_workers; workers++)
+    {
+        gfx::ImageLoader::set_workers(workers);
+
+        begin = std::chrono::steady_clock::now();
+
+        std::vector<gfx::ImageLoader::Result> results;
+        for(const auto& path : paths)
+            results.push_back(gfx::ImageLoader::load(path));
+        for(auto& result : results)
+            result.wait();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << workers << (workers == 1 ? " worker:   " : " workers:  ") 
+                  << elapsed.count() * 1000.0 << " ms" << std::endl;
+    }
+
+    for(const auto& path : paths)
+        std::remove(path.c_str());
+}
@@ -0,0 +1,132 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+// Drawing the same rectangles and circles every frame with
+// a draw call per object, with the batch and with instancing,
+// and printing how many shapes per second each one of them reached.
+//
+// Usage: ./instanced_benchmark [objects] [frames]
+
+static int objects = 20000;
+static int frames  = 100;
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    enum Workload { Rectangles, Circles, WorkloadCount };
+    enum Path { PerObject, Batched, Instanced, PathCount };
+
+    std::vector<gfx::Rectangle> rects;
+    std::vector<gfx::Circle> circles;
+
+    int workload = Rectangles;
+    int path = PerObject;
+    int frame = 0;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT),
+          gfx::GLFunctions(get_renderer())
+    {
+        std::mt19937 mt(1234);
+        std::uniform_int_distribution<int> x_dist(0, WIDTH);
+        std::uniform_int_distribution<int> y_dist(0, HEIGHT);
+        std::uniform_int_distribution<int> size_dist(2, 30);
+        std::uniform_int_distribution<int> color_dist(0, 255);
+
+        for(int i = 0; i < objects; i++)
+        {
+            gfx::Color color(color_dist(mt), color_dist(mt), color_dist(mt));
+
+            gfx::Rectangle rect;
+            rect.set_position(x_dist(mt), y_dist(mt));
+            rect.set_size(size_dist(mt), size_dist(mt));
+            rect.set_color(color);
+            rect.set_fill(i % 4 != 0);
+            rects.push_back(rect);
+
+            gfx::Circle circle;
+            circle.set_position(x_dist(mt), y_dist(mt));
+            circle.set_radius(size_dist(mt));
+            circle.set_color(color);
+            circle.set_fill(i % 4 != 0);
+            circles.push_back(circle);
+        }
+
+        gfx::GLExtensions extensions;
+        std::cout << "instancing: " << (extensions.instancing() ? "supported" : "not supported, falling back to batching") << std::endl;
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+        {
+            set_mode(path == Batched ? Mode::Batched : Mode::Immediate);
+            begin = std::chrono::steady_clock::now();
+        }
+
+        clear();
+        start();
+
+        if(path == Instanced)
+        {
+            if(workload == Rectangles)
+                draw_instanced(rects);
+            else
+                draw_instanced(circles);
+        }
+        else
+        {
+            if(workload == Rectangles)
+            {
+                for(auto& r : rects)
+                    draw(r);
+            }
+            else
+            {
+                for(auto& c : circles)
+                    draw(c);
+            }
+        }
+
+        swap_buffers();
+
+        if(++frame < frames)
+            return;
+
+        // Making sure the GPU is done before stopping the clock
+        glFinish();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        static const char* workloads[] = { "rectangles", "circles" };
+        static const char* paths[] = { "per object", "batched   ", "instanced " };
+        std::cout << paths[path] << " " << workloads[workload] << ": "
+                  << (objects * static_cast<double>(frames)) / elapsed.count() << " shapes/sec, "
+                  << frames / elapsed.count() << " frames/sec" << std::endl;
+
+        frame = 0;
+        if(++path == PathCount)
+        {
+            path = PerObject;
+            if(++workload == WorkloadCount)
+                close();
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) objects = std::stoi(argv[1]);
+    if(argc > 2) frames  = std::stoi(argv[2]);
+
+    gfx::construct_windows<Win>();
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "../src/include/gfx"
+#include <X11/Xlib.h>
+#include <chrono>
+#include <string>
+
+// Asking for the state of a key many times every frame, the way
+// input heavy tools are doing it, and printing how many queries
+// per second every way of asking reached:
+//   reconnect - opening and closing a display for every query,
+//               this is how key_pressed worked before
+//   shared    - key_pressed without a renderer, one shared display
+//   renderer  - key_pressed with the renderer, answered from the
+//               keys that were fetched once for the frame
+//
+// Usage: ./keyboard_benchmark [queries] [frames]
+
+static int queries = 10000;
+static int frames  = 100;
+
+// The old key_pressed
+static bool reconnect_key_pressed(unsigned int key)
+{
+    Display* dpy = XOpenDisplay(nullptr);
+
+    char keys_return[32];
+    XQueryKeymap(dpy, keys_return);
+    KeyCode kc2 = XKeysymToKeycode(dpy, key);
+    bool is_pressed = !!(keys_return[kc2 >> 3] & (1 << (kc2 & 7)));
+
+    XCloseDisplay(dpy);
+    return is_pressed;
+}
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    enum Method { Reconnect, Shared, Cached, MethodCount };
+
+    int method = Reconnect;
+    int frame = 0;
+    int pressed = 0;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::duration<double> elapsed;
+
+public:
+    Win()
+        : gfx::Renderer(200, 200),
+          gfx::GLFunctions(get_renderer()),
+          elapsed(0) {}
+
+    void on_update() override
+    {
+        // Connecting to X is so slow that it's only
+        // doing a small part of the queries
+        const int count = method == Reconnect ? queries / 100 : queries;
+        const auto key = gfx::Keyboard::Key::A;
+
+        // Only the queries are measured, not the frame
+        begin = std::chrono::steady_clock::now();
+        for(int i = 0; i < count; i++)
+        {
+            switch(method)
+            {
+            case Reconnect: pressed += reconnect_key_pressed(static_cast<unsigned int>(key)); break;
+            case Shared:    pressed += gfx::Keyboard::key_pressed(key); break;
+            case Cached:    pressed += gfx::Keyboard::key_pressed(get_renderer(), key); break;
+            }
+        }
+        elapsed += std::chrono::steady_clock::now() - begin;
+
+        clear();
+        swap_buffers();
+
+        if(++frame < frames)
+            return;
+
+        static const char* names[] = { "reconnect", "shared", "renderer" };
+        std::cout << names[method] << ": "
+                  << (count * static_cast<double>(frames)) / elapsed.count() << " queries/sec" << std::endl;
+
+        frame = 0;
+        elapsed = std::chrono::duration<double>(0);
+        if(++method == MethodCount)
+        {
+            // Using the result so the queries can't be removed
+            std::cout << "A was held in " << pressed << " queries" << std::endl;
+            close();
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) queries = std::stoi(argv[1]);
+    if(argc > 2) frames  = std::stoi(argv[2]);
+
+    gfx::construct_windows<Win>();
+}
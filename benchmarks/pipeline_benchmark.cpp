@@ -0,0 +1,151 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <cmath>
+#include <string>
+
+// Moving particles with a bit of physics and drawing them in a
+// headless window, once with the simulation and the drawing one
+// after the other and once with the frame pipeline, where the next
+// frame is simulated while the last one is drawn. The pipeline can
+// only be faster with at least two cores.
+//
+// Usage: ./pipeline_benchmark [particles] [frames] [buffers]
+
+static int    particle_count = 20000;
+static int    frames         = 100;
+static size_t buffers        = 2;
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    struct Particle
+    {
+        float x, y;
+        float vx, vy;
+    };
+
+    std::vector<Particle> particles;
+    std::vector<gfx::Rectangle> rects;
+    gfx::DrawList serial_list;
+    gfx::FramePipeline pipeline;
+
+    int frame = 0;
+    bool pipelined = false;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, Backend::Headless),
+          gfx::GLFunctions(get_renderer(), Mode::Batched),
+          pipeline(buffers)
+    {
+        for(int i = 0; i < particle_count; i++)
+        {
+            particles.push_back({
+                static_cast<float>((i * 37) % WIDTH), static_cast<float>((i * 91) % HEIGHT),
+                std::cos(static_cast<float>(i)), std::sin(static_cast<float>(i))
+            });
+
+            gfx::Rectangle rect;
+            rect.set_size(3, 3);
+            rect.set_color(gfx::Color(i % 256, 200, 255 - i % 256));
+            rects.push_back(rect);
+        }
+
+        set_capture(false);
+    }
+
+    ~Win() {
+        pipeline.stop();
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+            begin = std::chrono::steady_clock::now();
+
+        clear();
+        start();
+
+        if(pipelined)
+        {
+            const gfx::DrawList* list = pipeline.acquire();
+            if(list)
+                submit(*list);
+
+            swap_buffers();
+            glFinish();
+            pipeline.release();
+        }
+        else
+        {
+            serial_list.clear();
+            simulate(serial_list);
+            submit(serial_list);
+
+            swap_buffers();
+            glFinish();
+        }
+
+        if(++frame < frames)
+            return;
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << (pipelined ? "pipelined, " + std::to_string(buffers) + " buffers: " : "one after the other: ")
+                  << elapsed.count() / frames << " ms/frame" << std::endl;
+
+        frame = 0;
+        if(pipelined)
+        {
+            close();
+            return;
+        }
+
+        pipelined = true;
+        pipeline.start([this](gfx::DrawList& list) { simulate(list); });
+    }
+
+private:
+    // Every particle is pulled to the center and bounces off the
+    // edges, a few steps every frame like a physics engine
+    void simulate(gfx::DrawList& list)
+    {
+        for(int step = 0; step < 8; step++)
+        {
+            for(auto& p : particles)
+            {
+                const float dx = WIDTH / 2.f - p.x;
+                const float dy = HEIGHT / 2.f - p.y;
+                const float distance = std::sqrt(dx * dx + dy * dy) + 1.f;
+
+                p.vx += dx / (distance * distance) * 2.f;
+                p.vy += dy / (distance * distance) * 2.f;
+                p.x += p.vx * 0.125f;
+                p.y += p.vy * 0.125f;
+
+                if(p.x < 0.f || p.x > WIDTH)  p.vx = -p.vx;
+                if(p.y < 0.f || p.y > HEIGHT) p.vy = -p.vy;
+            }
+        }
+
+        for(size_t i = 0; i < particles.size(); i++)
+        {
+            rects[i].set_position(static_cast<int>(particles[i].x), static_cast<int>(particles[i].y));
+            list.add(rects[i]);
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) particle_count = std::stoi(argv[1]);
+    if(argc > 2) frames         = std::stoi(argv[2]);
+    if(argc > 3) buffers        = std::stoul(argv[3]);
+
+    gfx::construct_windows<Win>();
+}
@@ -0,0 +1,137 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+// Drawing the same rectangles every frame and sampling random pixels
+// of the window, first with a glReadPixels for every pixel (the way
+// Sprite::get_pixel is reading them), then with a single read of all
+// of the pixels, and then with a pixel buffer of the whole window that
+// is taken a few frames later. Printing how many pixels per second
+// were sampled, including the time of drawing the frames.
+//
+// Usage: ./pixel_reader_benchmark [pixels] [frames]
+
+static int pixels = 500;
+static int frames = 200;
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    enum Path { PerPixel, Batched, Async, PathCount };
+
+    gfx::PixelReader reader;
+    gfx::Sprite sprite;
+    std::vector<gfx::Rectangle> rects;
+    std::vector<gfx::VectorUI> points;
+    std::vector<gfx::Color> colors;
+
+    int path = PerPixel;
+    int frame = 0;
+    size_t sampled = 0;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT),
+          gfx::GLFunctions(get_renderer()),
+          reader(get_renderer())
+    {
+        std::mt19937 mt(1234);
+        std::uniform_int_distribution<int> x_dist(0, WIDTH - 1);
+        std::uniform_int_distribution<int> y_dist(0, HEIGHT - 1);
+        std::uniform_int_distribution<int> color_dist(0, 255);
+
+        for(int i = 0; i < 100; i++)
+        {
+            gfx::Rectangle rect;
+            rect.set_position(x_dist(mt), y_dist(mt));
+            rect.set_size(100, 100);
+            rect.set_color(gfx::Color(color_dist(mt), color_dist(mt), color_dist(mt)));
+            rects.push_back(rect);
+        }
+
+        for(int i = 0; i < pixels; i++)
+            points.emplace_back(x_dist(mt), y_dist(mt));
+
+        std::cout << "pixel buffers: " << (reader.is_async() ? "yes" : "no") << std::endl;
+        set_mode(Mode::Immediate);
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+        {
+            begin = std::chrono::steady_clock::now();
+            sampled = 0;
+        }
+
+        clear();
+        start();
+
+        for(const auto& rect : rects)
+            draw(rect);
+
+        if(path == PerPixel)
+        {
+            colors.resize(points.size());
+            for(size_t i = 0; i < points.size(); i++)
+                colors[i] = sprite.get_pixel(get_renderer(), points[i]);
+            sampled += points.size();
+        }
+        else if(path == Batched)
+        {
+            reader.read(points, colors);
+            sampled += points.size();
+        }
+        else
+        {
+            reader.request();
+
+            // Only the frames that are ready are counted
+            gfx::PixelReader::Region region;
+            while(reader.poll(region))
+            {
+                for(size_t i = 0; i < points.size(); i++)
+                    colors[i] = region.get_pixel(points[i].x, points[i].y);
+                sampled += points.size();
+            }
+        }
+
+        swap_buffers();
+
+        if(++frame < frames)
+            return;
+
+        // Making sure the GPU is done before stopping the clock
+        glFinish();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        const char* names[] = { "per pixel", "batched  ", "async    " };
+        std::cout << names[path] << ": " << sampled / elapsed.count() << " pixels/sec, "
+                  << frames / elapsed.count() << " frames/sec" << std::endl;
+
+        // Dropping the regions that are still being read
+        gfx::PixelReader::Region region;
+        while(reader.wait(region));
+
+        frame = 0;
+        colors.resize(points.size());
+        if(++path == PathCount)
+            close();
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) pixels = std::stoi(argv[1]);
+    if(argc > 2) frames = std::stoi(argv[2]);
+
+    gfx::construct_windows<Win>();
+}
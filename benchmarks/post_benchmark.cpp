@@ -0,0 +1,174 @@
+#include "../src/include/gfx"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+
+// Many threads are posting small tasks to a single headless window,
+// once with Renderer::post and once with a vector behind a mutex that
+// the window is taking every frame. It prints how many tasks every
+// second the window ran, the most tasks it ran in one frame, the
+// worst frame time and how often the producers had to retry because
+// the queue was full. The queue is bounded, so a flood of tasks is
+// slowing the producers down instead of the window.
+//
+// Usage: ./post_benchmark [max producers] [tasks per producer]
+
+static int max_producers = 16;
+static int tasks         = 100000;
+
+// What the current run is using
+static bool use_mutex = false;
+static int  producers = 1;
+
+static std::mutex mutex;
+static std::vector<std::function<void()>> locked_tasks;
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+public:
+    std::atomic<bool> ready;
+    std::atomic<long> executed;
+    long payload_sum = 0;
+    long most_in_frame = 0;
+
+    Win()
+        : gfx::Renderer(64, 64, Backend::HeadlessSoftware),
+          gfx::GLFunctions(get_renderer(), Mode::Batched),
+          ready(false), executed(0)
+    {
+        set_capture(false);
+    }
+
+    void on_update() override
+    {
+        ready = true;
+
+        if(use_mutex)
+        {
+            std::vector<std::function<void()>> taken;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                taken.swap(locked_tasks);
+            }
+
+            for(auto& task : taken)
+                task();
+        }
+
+        clear();
+        start();
+        swap_buffers();
+
+        if(executed == static_cast<long>(producers) * tasks)
+            close();
+    }
+};
+
+static void run()
+{
+    Win* window = nullptr;
+    std::atomic<bool> created(false);
+    std::atomic<size_t> retries(0);
+    double worst_frame = 0.0;
+
+    std::thread window_thread([&]() {
+        Win win;
+        window = &win;
+        created = true;
+
+        long before = 0;
+        auto frame_begin = std::chrono::steady_clock::now();
+
+        // The posted tasks are running inside of is_running, so the
+        // whole iteration is the frame
+        while(win.is_running())
+        {
+            win.on_update();
+
+            const auto frame_end = std::chrono::steady_clock::now();
+            worst_frame = std::max(worst_frame, std::chrono::duration<double, std::milli>(frame_end - frame_begin).count());
+            frame_begin = frame_end;
+
+            const long now = win.executed;
+            win.most_in_frame = std::max(win.most_in_frame, now - before);
+            before = now;
+        }
+    });
+
+    while(!created || !window->ready)
+        std::this_thread::yield();
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for(int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]() {
+            for(int i = 0; i < tasks; i++)
+            {
+                // The payload is the same kind of data a network thread
+                // would hand over, it's captured by the task
+                const int payload = p * tasks + i;
+                Win* win = window;
+                std::function<void()> task = [win, payload]() {
+                    win->payload_sum += payload;
+                    win->executed.fetch_add(1, std::memory_order_relaxed);
+                };
+
+                if(use_mutex)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    locked_tasks.push_back(std::move(task));
+                    continue;
+                }
+
+                // The window is drawing slower than the tasks are posted
+                while(!window->post(task))
+                {
+                    retries++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for(auto& th : threads)
+        th.join();
+
+    // The window is closing once it ran every task
+    while(window->executed != static_cast<long>(producers) * tasks)
+        std::this_thread::yield();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    const long most_in_frame = window->most_in_frame;
+    window_thread.join();
+
+    std::printf("%-6s %10d %14.0f %14ld %14.3f %10zu\n",
+        use_mutex ? "mutex" : "post", producers,
+        producers * static_cast<double>(tasks) / elapsed.count(),
+        most_in_frame, worst_frame,
+        static_cast<size_t>(retries));
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) max_producers = std::stoi(argv[1]);
+    if(argc > 2) tasks         = std::stoi(argv[2]);
+
+    std::printf("%-6s %10s %14s %14s %14s %10s\n", "mode", "producers", "tasks/sec", "most/frame", "worst ms", "retries");
+
+    for(producers = 1; producers <= max_producers; producers *= 2)
+    {
+        use_mutex = false;
+        run();
+
+        use_mutex = true;
+        run();
+    }
+}
@@ -0,0 +1,124 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <string>
+
+// Printing how long a single zone takes when the profiler is enabled
+// and when it's disabled, and then drawing rectangles in a headless
+// window with the profiler enabled and disabled. The zones of the
+// library are only timed when it was built with -DGFX_PROFILE=ON,
+// the trace of the window is written into profile.json.
+//
+// Usage: ./profiler_benchmark [zones] [frames]
+
+static int zones  = 1000000;
+static int frames = 200;
+
+static double zone_cost(bool enabled)
+{
+    gfx::Profiler::set_enabled(enabled);
+
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < zones; i++)
+    {
+        gfx::ProfileZone zone("benchmark zone");
+
+        // Taking the zones before the ring buffer is full
+        if((i & 0x7fff) == 0x7fff)
+            gfx::Profiler::collect();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+
+    gfx::Profiler::collect();
+    gfx::Profiler::clear();
+    return elapsed.count() / zones;
+}
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 800;
+    static constexpr int HEIGHT = 600;
+
+    std::vector<gfx::Rectangle> rects;
+    int frame = 0;
+    bool enabled = false;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, Backend::Headless),
+          gfx::GLFunctions(get_renderer(), Mode::Batched)
+    {
+        for(int i = 0; i < 1000; i++)
+        {
+            gfx::Rectangle rect;
+            rect.set_position((i * 37) % WIDTH, (i * 91) % HEIGHT);
+            rect.set_size(20, 20);
+            rect.set_color(gfx::Color(i % 256, 128, 255 - i % 256));
+            rects.push_back(rect);
+        }
+
+        set_capture(false);
+        gfx::Profiler::set_thread_name("headless window");
+        gfx::Profiler::set_enabled(enabled);
+    }
+
+    void on_update() override
+    {
+        if(frame == 0)
+            begin = std::chrono::steady_clock::now();
+
+        clear();
+        start();
+
+        for(const auto& rect : rects)
+            draw(rect);
+
+        swap_buffers();
+
+        // Only the zones of the last frame are going to be lost
+        if(gfx::Profiler::is_enabled())
+            gfx::Profiler::collect();
+
+        if(++frame < frames)
+            return;
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << "window, profiler " << (enabled ? "enabled:  " : "disabled: ")
+                  << frames / elapsed.count() << " frames/sec" << std::endl;
+
+        frame = 0;
+        if(enabled)
+        {
+            gfx::Profiler::set_enabled(false);
+            close();
+            return;
+        }
+
+        enabled = true;
+        gfx::Profiler::set_enabled(true);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) zones  = std::stoi(argv[1]);
+    if(argc > 2) frames = std::stoi(argv[2]);
+
+#ifdef GFX_PROFILE
+    std::cout << "library zones: compiled" << std::endl;
+#else
+    std::cout << "library zones: not compiled" << std::endl;
+#endif
+
+    std::cout << "zone, profiler disabled: " << zone_cost(false) << " ns" << std::endl;
+    std::cout << "zone, profiler enabled:  " << zone_cost(true) << " ns" << std::endl;
+
+    gfx::construct_windows<Win>();
+
+    if(gfx::Profiler::write_chrome_trace("profile.json"))
+        std::cout << gfx::Profiler::get_records().size() << " zones written into profile.json, "
+                  << gfx::Profiler::get_dropped() << " dropped" << std::endl;
+}
@@ -0,0 +1,134 @@
+#include "../src/include/gfx"
+#include <sys/resource.h>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <cstdio>
+
+// Running more and more headless windows, once with a thread for
+// every window like construct_windows and once with the window
+// scheduler, and printing the frames per second of all of the windows
+// together and how much of a core the process was using.
+//
+// Usage: ./scheduler_benchmark [max windows] [frames] [target fps] [workers]
+// A target of 0 is running every window as fast as possible.
+
+static int    max_windows = 32;
+static int    frames      = 60;
+static double target_fps  = 60.0;
+static size_t workers     = gfx::ThreadPool::hardware_workers();
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH  = 320;
+    static constexpr int HEIGHT = 240;
+
+    std::vector<gfx::Rectangle> rects;
+    int frame = 0;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, Backend::Headless),
+          gfx::GLFunctions(get_renderer(), Mode::Batched)
+    {
+        for(int i = 0; i < 200; i++)
+        {
+            gfx::Rectangle rect;
+            rect.set_position((i * 37) % WIDTH, (i * 91) % HEIGHT);
+            rect.set_size(10, 10);
+            rect.set_color(gfx::Color(i % 256, 128, 255 - i % 256));
+            rects.push_back(rect);
+        }
+
+        set_capture(false);
+        set_target_fps(target_fps);
+    }
+
+    void on_update() override
+    {
+        clear();
+        start();
+
+        for(const auto& rect : rects)
+            draw(rect);
+
+        swap_buffers();
+
+        if(++frame == frames)
+            close();
+    }
+};
+
+// The CPU time of every thread of the process, in seconds
+static double cpu_time()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+// The same loop that construct_windows is running
+static void run_threads(int windows)
+{
+    std::vector<std::thread> threads;
+    for(int i = 0; i < windows; i++)
+    {
+        threads.emplace_back([]() {
+            Win win;
+            while(win.is_running())
+            {
+                win.on_update();
+                win.wait_for_next_frame();
+            }
+        });
+    }
+
+    for(auto& th : threads)
+        th.join();
+}
+
+static void run_scheduler(int windows)
+{
+    gfx::WindowScheduler scheduler(workers);
+    scheduler.add<Win>(windows);
+    scheduler.run();
+}
+
+static void measure(const char* mode, int windows, void (*run)(int))
+{
+    const double cpu_begin = cpu_time();
+    const auto begin = std::chrono::steady_clock::now();
+
+    run(windows);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    const double cpu = cpu_time() - cpu_begin;
+
+    std::printf("%-10s %8d %14.1f %10.2f %9.1f%%\n",
+        mode, windows, windows * frames / elapsed.count(), elapsed.count(), cpu / elapsed.count() * 100.0);
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) max_windows = std::stoi(argv[1]);
+    if(argc > 2) frames      = std::stoi(argv[2]);
+    if(argc > 3) target_fps  = std::stod(argv[3]);
+    if(argc > 4) workers     = std::stoul(argv[4]);
+
+    // The windows are printing their renderer, it's
+    // not needed in the middle of the table
+    std::cout.setstate(std::ios::failbit);
+
+    std::printf("target %.0f fps, %d frames per window, %zu workers\n", target_fps, frames, workers);
+    std::printf("%-10s %8s %14s %10s %10s\n", "mode", "windows", "frames/sec", "seconds", "cpu");
+
+    for(int windows = 1; windows <= max_windows; windows *= 2)
+    {
+        measure("threads", windows, run_threads);
+        measure("scheduler", windows, run_scheduler);
+    }
+}
@@ -0,0 +1,84 @@
+#include "../src/include/gfx"
+#include <chrono>
+#include <string>
+#include <cmath>
+
+// Drawing a few frames without a window and writing the
+// last one into thumbnail.ppm, it works without an X server.
+//
+// Usage: ./headless_thumbnail [software]
+
+static gfx::Renderer::Backend backend = gfx::Renderer::Backend::Headless;
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH = 320;
+    static constexpr int HEIGHT = 240;
+    static constexpr int FRAMES = 100;
+
+    int frame = 0;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, backend),
+          gfx::GLFunctions(get_renderer())
+    {
+        std::cout << "drawing with " << (get_backend() == Backend::Software ? "software" : "OpenGL") << std::endl;
+
+        // Only the last frame is needed
+        set_capture(false);
+        begin = std::chrono::steady_clock::now();
+    }
+
+    void on_update() override
+    {
+        clear(gfx::Color(30, 30, 40));
+        start();
+
+        for(int i = 0; i < 12; i++)
+        {
+            const float angle = (frame + i * 30) * 0.05f;
+
+            gfx::Rectangle rect;
+            rect.set_position(WIDTH / 2 + static_cast<int>(std::cos(angle) * 100) - 10,
+                              HEIGHT / 2 + static_cast<int>(std::sin(angle) * 80) - 10);
+            rect.set_size(20, 20);
+            rect.set_color(gfx::Color(i * 20, 255 - i * 20, 160));
+            draw(rect);
+        }
+
+        gfx::Circle circle;
+        circle.set_position(WIDTH / 2, HEIGHT / 2);
+        circle.set_radius(30);
+        circle.set_color(gfx::Color(255, 200, 0));
+        draw(circle);
+
+        if(++frame == FRAMES)
+            set_capture(true);
+
+        swap_buffers();
+
+        if(frame < FRAMES)
+            return;
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << FRAMES / elapsed.count() << " frames/sec" << std::endl;
+
+        if(save_frame("thumbnail.ppm"))
+            std::cout << "saved thumbnail.ppm" << std::endl;
+
+        close();
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc > 1 && std::string(argv[1]) == "software")
+        backend = gfx::Renderer::Backend::HeadlessSoftware;
+
+    gfx::construct_windows<Win>();
+}
@@ -31,11 +31,12 @@ public:
 
         if(gfx::Mouse::button_pressed(get_renderer(), gfx::Mouse::Button::Left))
         {
-            for(size_t y = 0; y < spr.get_texture_size().height; y++)
-            {
-                for(size_t x = 0; x < spr.get_texture_size().width; x++)
-                    spr.set_pixel(x, y, gfx::Color(100, 0, 255));
-            }
+            // Every pixel is uploaded at once on the next draw
+            gfx::Color* pixels = spr.lock_pixels();
+            const size_t count = spr.get_texture_size().width * spr.get_texture_size().height;
+            for(size_t i = 0; i < count; i++)
+                pixels[i] = gfx::Color(100, 0, 255);
+            spr.unlock_pixels();
         }
 
         double framerate = get_framerate();
@@ -33,7 +33,7 @@ public:
             auto pos = gfx::Mouse::motion(get_renderer());
             circle.set_position(pos);
 
-            if(gfx::Keyboard::key_pressed(gfx::Keyboard::Key::A))
+            if(gfx::Keyboard::key_pressed(get_renderer(), gfx::Keyboard::Key::A))
                 std::cout << "Window 1: A!!" << std::endl;
 
             swap_buffers();
@@ -74,7 +74,7 @@ public:
             auto pos = gfx::Mouse::motion(get_renderer());
             rect.set_position(pos);
 
-            if(gfx::Keyboard::key_pressed(gfx::Keyboard::Key::A))
+            if(gfx::Keyboard::key_down(get_renderer(), gfx::Keyboard::Key::A))
                 std::cout << "Window 2: A!!" << std::endl;
 
             swap_buffers();
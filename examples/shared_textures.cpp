@@ -0,0 +1,132 @@
+#include "../src/include/gfx"
+#include "../src/include/texture_cache.hpp"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstring>
+
+// Five windows that are loading the same images, with a share group
+// the images are decoded and uploaded by the first window only and
+// the other windows are using its textures. Every window prints how
+// long the loading took, and the last one prints the memory of the
+// textures and the video memory when the driver is reporting it.
+//
+// Usage: ./shared_textures [no-share] [headless] [images...]
+
+#ifndef GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#endif
+
+static bool share = true;
+static gfx::Renderer::Backend backend = gfx::Renderer::Backend::OpenGL;
+static std::vector<std::string> images;
+
+static gfx::ShareGroup group;
+
+static std::mutex print_mutex;
+static int loaded_windows = 0;
+static double total_load_ms = 0.0;
+static GLint first_available_kb = -1;
+
+// The available video memory in kilobytes, or -1 if it's unknown
+static GLint available_memory_kb()
+{
+    const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if(!extensions || !std::strstr(extensions, "GL_NVX_gpu_memory_info"))
+        return -1;
+
+    GLint available = -1;
+    glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+    return available;
+}
+
+class Win
+    : public gfx::Renderer,
+             gfx::GLFunctions
+{
+private:
+    static constexpr int WIDTH = 400;
+    static constexpr int HEIGHT = 300;
+    static constexpr int WINDOWS = 5;
+    static constexpr int FRAMES = 60;
+
+    std::vector<gfx::Sprite> sprites;
+    int frame = 0;
+
+public:
+    Win()
+        : gfx::Renderer(WIDTH, HEIGHT, backend, share ? &group : nullptr),
+          gfx::GLFunctions(get_renderer())
+    {
+        set_title(share ? "Shared textures" : "Textures of every window");
+        set_capture(false);
+
+        const GLint available_before = available_memory_kb();
+        const auto begin = std::chrono::steady_clock::now();
+
+        for(size_t i = 0; i < images.size(); i++)
+        {
+            sprites.emplace_back();
+            sprites.back().create(images[i], 96, 96, static_cast<int>(i % 4) * 100, static_cast<int>(i / 4) * 100);
+        }
+
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "window " << loaded_windows << ": loaded " << images.size()
+                  << " images in " << elapsed.count() << " ms" << std::endl;
+
+        total_load_ms += elapsed.count();
+        if(first_available_kb < 0)
+            first_available_kb = available_before;
+
+        if(++loaded_windows < WINDOWS)
+            return;
+
+        std::cout << (share ? "shared" : "not shared") << ", " << group.get_window_count() << " windows in the group" << std::endl;
+        std::cout << "loading of every window: " << total_load_ms << " ms" << std::endl;
+        std::cout << "texture memory: " << gfx::TextureCache::get_memory_usage() / 1024 << " KB in "
+                  << gfx::TextureCache::get_texture_count() << " textures" << std::endl;
+
+        const GLint available_after = available_memory_kb();
+        if(first_available_kb >= 0 && available_after >= 0)
+            std::cout << "video memory used: " << first_available_kb - available_after << " KB" << std::endl;
+        else
+            std::cout << "video memory used: unknown, the driver is not reporting it" << std::endl;
+    }
+
+    void on_update() override
+    {
+        clear();
+        start();
+
+        for(const auto& sprite : sprites)
+            draw(sprite);
+
+        swap_buffers();
+
+        // There is nobody to close a headless window
+        if(is_headless() && ++frame == FRAMES)
+            close();
+    }
+};
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if(arg == "no-share")
+            share = false;
+        else if(arg == "headless")
+            backend = gfx::Renderer::Backend::Headless;
+        else
+            images.push_back(arg);
+    }
+
+    if(images.empty())
+        images.push_back("cubes.png");
+
+    gfx::construct_windows<Win, Win, Win, Win, Win>();
+}
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the vertex batch, every shape    //
+// that is drawn in batched mode is turned into plain    //
+// triangles or lines and appended into a CPU stream,    //
+// the stream is then submitted with as few draw calls   //
+// as possible (one per state change).                   //
+///////////////////////////////////////////////////////////
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "utils/utils.hpp"
+#include "utils/color.hpp"
+#include "utils/vector.hpp"
+#include "utils/matrix.hpp"
+
+#include <vector>
+#include <cstddef>
+
+START_NAMESPACE
+
+// Forward Declaration
+struct BatchCache;
+class Rectangle;
+class Circle;
+class Shape;
+class Sprite;
+
+// A single vertex as OpenGL is going to read it
+struct BatchVertex
+{
+    float x, y;       // Position
+    float u, v;       // Texture coordinates
+    Color color;      // Given to OpenGL as normalized bytes
+}; // BatchVertex
+
+class Batch
+{
+public:
+    // All of the primitives that can be merged
+    // into a single draw call
+    enum class Primitive
+    {
+        Triangles, Lines
+    }; // Primitive
+
+    // A range of vertices that shares the same state
+    struct Command
+    {
+        Primitive primitive;
+        unsigned int texture;
+        size_t first;
+        size_t count;
+    }; // Command
+
+    // ------------------------------------------------------------ //
+
+    // Appending shapes into the stream, the matrix is
+    // applied on the CPU to every vertex.
+    // The transformed vertices are kept inside the shape, and
+    // they are copied as they are until the shape or the
+    // matrix is changed
+    void add(const Rectangle& rect, const Matrix& matrix);
+    void add(const Circle& circle, const Matrix& matrix);
+    void add(const Shape& shape, const Matrix& matrix);
+    void add(const Sprite& sprite, const Matrix& matrix);
+
+    // ------------------------------------------------------------ //
+
+    // Submitting all of the vertices to OpenGL
+    // and clearing the stream afterwards
+    void flush();
+
+    // Dropping all of the vertices without drawing them
+    void clear() noexcept;
+
+    // Appending the vertices of another batch after these,
+    // the commands with the same state are merged
+    void append(const Batch& other);
+
+    // ------------------------------------------------------------ //
+
+    bool empty() const noexcept;
+    size_t vertex_count() const noexcept;
+    size_t command_count() const noexcept;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // Reusing the vertices of the shape if nothing was changed,
+    // otherwise it's tessellated again and the cache is updated
+    template<typename T>
+    void add_cached(const T& shape, const Matrix& matrix);
+
+    // Building the vertices of a shape
+    void tessellate(const Rectangle& rect, const Matrix& matrix);
+    void tessellate(const Circle& circle, const Matrix& matrix);
+    void tessellate(const Shape& shape, const Matrix& matrix);
+    void tessellate(const Sprite& sprite, const Matrix& matrix);
+
+    // Starts a new command if the state is different
+    // than the last command
+    void begin(Primitive primitive, unsigned int texture);
+
+    // Appending a single vertex to the last command
+    void push(const Matrix& matrix, float x, float y, const Color& color);
+    void push(const Matrix& matrix, float x, float y, float u, float v);
+
+    // Appending a single line as two vertices
+    void push_line(const Matrix& matrix, const VectorF& from, const Color& from_color,
+                   const VectorF& to, const Color& to_color);
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    std::vector<BatchVertex> m_vertices;
+    std::vector<Command> m_commands;
+
+    friend class SoftwareRasterizer;
+}; // Batch
+
+// ------------------------------------------------------------ //
+
+// The vertices of a single shape after they were transformed
+struct BatchCache
+{
+    std::vector<BatchVertex> vertices;
+    Batch::Primitive primitive;
+    unsigned int texture;
+
+    // What the vertices were built from
+    unsigned long version;
+    Matrix matrix;
+    bool valid;
+
+    BatchCache()
+        : primitive(Batch::Primitive::Triangles), texture(0), version(0), valid(false) {}
+}; // BatchCache
+
+END_NAMESPACE
+
+#endif // BATCH_HPP
\ No newline at end of file
@@ -11,6 +11,7 @@
 #define CONSTRUCTION_HPP
 
 #include "utils/utils.hpp"
+#include "profiler.hpp"
 
 #ifdef _WIN32
 #include "windows/renderer.hpp"
@@ -42,7 +43,15 @@ void _GFX_construct_window()
         void {
             U win;
             while(win.is_running())
-                win.on_update();
+            {
+                {
+                    GFX_PROFILE_ZONE("on_update");
+                    win.on_update();
+                }
+
+                // Nothing is waiting without a target frame rate
+                win.wait_for_next_frame();
+            }
         }
     );
 
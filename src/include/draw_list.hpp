@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the draw list, the shapes are    //
+// turned into vertices without touching OpenGL, so a    //
+// frame can be recorded by many threads and submitted   //
+// by the thread of the window afterwards.               //
+///////////////////////////////////////////////////////////
+
+#ifndef DRAW_LIST_HPP
+#define DRAW_LIST_HPP
+
+#include "utils/utils.hpp"
+#include "utils/matrix.hpp"
+#include "batch.hpp"
+#include "draws/rectangle.hpp"
+#include "draws/circle.hpp"
+#include "draws/shape.hpp"
+#include "draws/sprite.hpp"
+
+#include <vector>
+
+START_NAMESPACE
+
+class DrawList
+{
+public:
+    DrawList();
+
+    // ------------------------------------------------------------ //
+
+    // Recording the shapes, it can be done from any thread but
+    // a list is filled by one thread at a time. A shape keeps its
+    // vertices inside of it, so it cannot be added into two lists
+    // on two threads at the same time.
+    // A sprite that is still loading is not recorded, and the
+    // pixels of a sprite are uploaded when the list is submitted,
+    // so it has to live until then. The sprite is locked while
+    // it's recorded and uploaded, so the window can submit an
+    // older list with it while a new one is recorded
+    void add(const Rectangle& rectangle);
+    void add(const Circle& circle);
+    void add(const Shape& shape);
+    void add(const Sprite& sprite);
+
+    // ------------------------------------------------------------ //
+
+    // The transform stack of the list, it's working like the one
+    // of GLFunctions. The transform stack of GLFunctions is not
+    // applied on a list when it's submitted
+    void push_transform(const Transformation& transformation);
+    void push_transform(const Matrix& matrix);
+    void pop_transform();
+
+    const Matrix& get_transform() const;
+
+    // ------------------------------------------------------------ //
+
+    // Dropping everything that was recorded and the transform
+    // stack, the memory is kept for the next frame
+    void clear();
+
+    bool empty() const;
+    size_t vertex_count() const;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // The matrix of a shape, including the transform stack
+    Matrix transform(const Transformation& transformation) const;
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    Batch m_batch;
+
+    // The first matrix is always identity
+    std::vector<Matrix> m_transforms;
+
+    // Sprites that are waiting for an upload
+    // on the thread of the window
+    std::vector<const Sprite*> m_uploads;
+
+    friend class GLFunctions;
+}; // DrawList
+
+END_NAMESPACE
+
+#endif // DRAW_LIST_HPP
@@ -57,6 +57,8 @@ private:
     bool m_fill;
 
     friend class GLFunctions;
+    friend class Batch;
+    friend class InstanceRenderer;
 }; // Circle
 
 END_NAMESPACE
@@ -59,6 +59,8 @@ private:
     bool m_fill;
 
     friend class GLFunctions;
+    friend class Batch;
+    friend class InstanceRenderer;
 }; // Rectangle
 
 END_NAMESPACE
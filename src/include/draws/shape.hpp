@@ -65,6 +65,7 @@ private:
     bool m_connect;
 
     friend class GLFunctions;
+    friend class Batch;
 }; // Shape
 
 END_NAMESPACE
@@ -11,8 +11,11 @@
 #include "../utils/color.hpp"
 
 #include "transformation.hpp"
+#include "../texture_atlas.hpp"
+#include "../image_loader.hpp"
 
 #include <vector>
+#include <mutex>
 
 START_NAMESPACE
 
@@ -23,21 +26,44 @@ class Sprite : public Transformation
 {
 public:
     // Create
-    Sprite() = default;
+    Sprite();
     Sprite(const std::string& path, const VectorI& position);
     Sprite(const std::string& path, int x, int y);
     Sprite(const std::string& path, const Geometry& geometry, const VectorI& position);
     Sprite(const std::string& path, unsigned int width, unsigned int height, int x, int y);
+    Sprite(const TextureAtlas::Region& region, const VectorI& position);
     ~Sprite();
 
+    // Copies are sharing the same texture
+    Sprite(const Sprite& sprite);
+    Sprite& operator=(const Sprite& sprite);
+
     // ------------------------------------------------------------ //
 
-    // Create
+    // Create, the image is only loaded once and every
+    // sprite of the same image is sharing its texture
     void create(const std::string& path, const VectorI& position);
     void create(const std::string& path, int x, int y);
     void create(const std::string& path, const Geometry& geometry, const VectorI& position);
     void create(const std::string& path, unsigned int width, unsigned int height, int x, int y);
 
+    // Using an image inside an atlas, the sprite doesn't own the
+    // texture so the atlas has to outlive the sprite. Every sprite
+    // of the same atlas page is drawn in a single batched draw call
+    void create(const TextureAtlas::Region& region, const VectorI& position);
+    void create(const TextureAtlas::Region& region, unsigned int width, unsigned int height, int x, int y);
+
+    // The image is decoded on the image loader workers, and the
+    // sprite is not drawn until it's ready. The texture is uploaded
+    // the first time the sprite is drawn after the image was decoded
+    void create_async(const std::string& path, const Geometry& geometry, const VectorI& position);
+    void create_async(const std::string& path, unsigned int width, unsigned int height, int x, int y);
+
+    // True if the sprite has a texture that can be drawn
+    bool is_ready() const;
+    // True if the image is still being decoded or uploaded
+    bool is_loading() const;
+
     // ------------------------------------------------------------ //
 
     // Size
@@ -55,28 +81,114 @@ public:
 
     // ------------------------------------------------------------ //
 
-    // Pixels
+    // Pixels, the first write gives the sprite its own texture
+    // so the other sprites of the same image are not changed.
+    // The pixels are written into a copy of the texture on the CPU,
+    // and everything that was changed is uploaded at once the next
+    // time the sprite is drawn, so they must be called from the
+    // thread of the context. Writing before an async sprite is
+    // ready does nothing
     void set_pixel(const VectorUI& position, Color& color);
     void set_pixel(const VectorUI& position, Color&& color);
     void set_pixel(unsigned int x, unsigned int y, Color& color);
     void set_pixel(unsigned int x, unsigned int y, Color&& color);
 
+    // Writing a block of size.width * size.height
+    // colors, row after row
+    void set_pixels(const VectorUI& position, const Geometry& size, const Color* colors);
+    void set_pixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height, const Color* colors);
+
+    // Direct access to the copy of the texture, get_texture_size().width
+    // colors in every row. Everything is uploaded again after unlock.
+    // Throws if the sprite is not ready or if it's already locked
+    Color* lock_pixels();
+    void unlock_pixels();
+
+    // Reading a pixel of the window, it waits for the GPU on every
+    // call, PixelReader is reading many of them at once
     Color get_pixel(const Renderer& renderer, const VectorUI& position);
     Color get_pixel(const Renderer& renderer, unsigned int x, unsigned int y);
 
     // ------------------------------------------------------------ //
 
+private:
+    // Uploading the image of an async load if it was decoded and
+    // the pixels that were changed since the last draw, returns false
+    // if the sprite cannot be drawn yet.
+    // It must be called from the thread of the context
+    bool resolve() const;
+
+    // The two parts of resolve, the sprite has to be locked already.
+    // Taking the image of an async load once it was decoded, returns
+    // false if the sprite has no texture yet
+    bool finish_load() const;
+    // Uploading the pixels that were changed since the last upload
+    void upload_pixels() const;
+
+    // Reading the texture into the copy of the pixels
+    // if it wasn't read yet, returns false if there's no texture
+    bool read_pixels();
+
+    // Called before writing, the texture is replaced with a copy
+    // unless nothing else is using it. Returns false if there's
+    // no texture
+    bool detach();
+
+    // Adding a rectangle to the pixels that has to be uploaded
+    void mark_dirty(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
+    // Forgetting the copy of the pixels, the texture was replaced
+    void reset_pixels();
+
+    // ------------------------------------------------------------ //
+
 #ifdef GFX_ACCESS_EVERYTHING
 public:
 #else
 private:
 #endif
-    unsigned int id;
+    // The texture is set later by an async load
+    mutable unsigned int id;
     VectorI m_position;
     Geometry m_geometry;
-    Geometry original_geometry;
+    mutable Geometry original_geometry;
+
+    // The part of the texture that is drawn, the whole
+    // texture unless it's coming from an atlas
+    VectorUI m_texture_offset;
+    VectorF m_uv_min;
+    VectorF m_uv_max;
+
+    // The texture was taken from the texture cache,
+    // and it's released by the sprite
+    mutable bool m_owns_texture;
+
+    // Nothing else is using the texture since it was last
+    // checked, it's cleared whenever the texture is replaced
+    // or shared with a copy
+    mutable bool m_detached;
+
+    // The image of an async load, the path is kept
+    // after a failure so it's never drawn
+    mutable ImageLoader::Result m_pending;
+    mutable std::string m_pending_path;
+
+    // The copy of the texture that set_pixel is writing into, and
+    // the part of it that was changed since the last upload. Once
+    // it's written the texture belongs only to this sprite
+    std::vector<Color> m_pixels;
+    mutable VectorUI m_dirty_min;
+    mutable VectorUI m_dirty_max;
+    bool m_locked;
+
+    // Guarding the texture, the async load and the pixels, a draw
+    // list may be recording the sprite on another thread while the
+    // window is resolving it for an older list
+    mutable std::mutex m_mutex;
     
     friend class GLFunctions;
+    friend class Batch;
+    friend class DrawList;
 }; // Sprite
 
 END_NAMESPACE
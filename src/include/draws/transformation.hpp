@@ -13,6 +13,8 @@
 #include "../utils/utils.hpp"
 #include "../utils/vector.hpp"
 #include "../utils/geometry.hpp"
+#include "../utils/matrix.hpp"
+#include "../batch.hpp"
 
 START_NAMESPACE
 
@@ -44,6 +46,25 @@ public:
 
     // ------------------------------------------------------------ //
 
+    // The translate * rotation * scale matrix, it's only
+    // calculated again after one of them was changed
+    const Matrix& get_matrix() const;
+
+    // ------------------------------------------------------------ //
+
+    // Changed every time anything that affects the way
+    // the shape looks was changed
+    unsigned long get_version() const;
+
+    // ------------------------------------------------------------ //
+
+protected:
+    // Called by every setter of the derived shapes,
+    // the cached vertices are going to be built again
+    void touch() noexcept;
+
+    // ------------------------------------------------------------ //
+
 #ifdef GFX_ACCESS_EVERYTHING
 public:
 #else
@@ -53,7 +74,20 @@ private:
     VectorF m_scale;
     double m_degree;
 
+private:
+    // Calculated lazily from the members above
+    mutable Matrix m_matrix;
+    mutable bool m_matrix_dirty;
+
+    unsigned long m_version;
+
+    // The vertices of the last time the shape was batched,
+    // a shape shouldn't be drawn by two windows at the same time
+    mutable BatchCache m_cache;
+
     friend class GLFunctions;
+    friend class Batch;
+    friend class InstanceRenderer;
 };
 
 END_NAMESPACE
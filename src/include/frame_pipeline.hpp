@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the frame pipeline, a thread is  //
+// simulating the next frame into a draw list while the  //
+// window is drawing the last one, the lists are reused  //
+// so nothing is allocated once they are big enough.     //
+///////////////////////////////////////////////////////////
+
+#ifndef FRAME_PIPELINE_HPP
+#define FRAME_PIPELINE_HPP
+
+#include "utils/utils.hpp"
+#include "draw_list.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+START_NAMESPACE
+
+class FramePipeline
+{
+public:
+    // Double or triple buffered, with three buffers the simulation
+    // can be a frame ahead while a frame waits to be drawn
+    static constexpr size_t MAX_BUFFERS = 3;
+
+    explicit FramePipeline(size_t buffers = 2);
+
+    // Stopping the simulation
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Calling the function on the simulation thread for every frame,
+    // it's recording the frame into an empty list. Everything it's
+    // changing must not be touched by the window while it's running.
+    // Sprites are the exception, the window uploads them when it
+    // submits a list and they are locked while it does, but only
+    // the window can create them or write their pixels.
+    // Throws if it was already started
+    void start(std::function<void(DrawList&)> simulate);
+
+    // Waiting for the frame that is simulated right now, and
+    // dropping the frames that were not drawn
+    void stop();
+
+    // ------------------------------------------------------------ //
+
+    // Called by the window, it's waiting until the oldest frame was
+    // simulated and it stays untouched until release. Returns nullptr
+    // if the pipeline is stopped, and throws what the simulation threw
+    const DrawList* acquire();
+
+    // The list can be simulated into again
+    void release();
+
+    // ------------------------------------------------------------ //
+
+    // The number of the last frame that was acquired, from 0
+    unsigned long get_frame_number() const;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // The loop of the simulation thread
+    void simulate();
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    DrawList m_lists[MAX_BUFFERS];
+    size_t m_buffers;
+
+    // The lists are simulated and drawn in a ring, from the oldest
+    // list that was simulated and not released yet
+    size_t m_first;
+    size_t m_ready;
+    bool m_acquired;
+
+    unsigned long m_frame_number;
+
+    std::function<void(DrawList&)> m_simulate;
+    std::exception_ptr m_error;
+    bool m_running;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+}; // FramePipeline
+
+END_NAMESPACE
+
+#endif // FRAME_PIPELINE_HPP
@@ -37,7 +37,13 @@
 // ------------------------------------------------------------ //
 
 #include "glfunctions.hpp"
+#include "draw_list.hpp"
+#include "frame_pipeline.hpp"
+#include "pixel_reader.hpp"
+#include "share_group.hpp"
+#include "profiler.hpp"
 #include "construction.hpp"
+#include "window_scheduler.hpp"
 
 #include "utils/vector.hpp"
 #include "utils/geometry.hpp"
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header is loading all of the OpenGL functions    //
+// that are not part of OpenGL 1.1, and checking which   //
+// of the features are supported by the current context. //
+///////////////////////////////////////////////////////////
+
+#ifndef GLEXTENSIONS_HPP
+#define GLEXTENSIONS_HPP
+
+#include "utils/utils.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/GL.h>
+#include <GL/glext.h>
+#elif __linux__
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+#include <string>
+
+START_NAMESPACE
+
+class GLExtensions
+{
+public:
+    // Loading all of the functions from the current context,
+    // so it must be created after the context was made current
+    GLExtensions();
+
+    // ------------------------------------------------------------ //
+
+    // Checks if the context supports an extension
+    bool has_extension(const std::string& name) const;
+
+    // Checks if the context version is at least major.minor
+    bool has_version(int major, int minor) const;
+
+    // ------------------------------------------------------------ //
+
+    // Vertex and pixel buffer objects
+    bool buffers() const;
+    // GLSL shaders
+    bool shaders() const;
+    // Instanced arrays and instanced draws
+    bool instancing() const;
+    // Fences that tell when the GPU is done with the commands
+    bool fences() const;
+    // Timestamps of the GPU that are read a few frames later
+    bool timer_queries() const;
+
+    // ------------------------------------------------------------ //
+
+    // Buffer objects
+    PFNGLGENBUFFERSPROC    gen_buffers;
+    PFNGLDELETEBUFFERSPROC delete_buffers;
+    PFNGLBINDBUFFERPROC    bind_buffer;
+    PFNGLBUFFERDATAPROC    buffer_data;
+    PFNGLBUFFERSUBDATAPROC buffer_sub_data;
+    PFNGLMAPBUFFERPROC     map_buffer;
+    PFNGLUNMAPBUFFERPROC   unmap_buffer;
+
+    // Shaders
+    PFNGLCREATESHADERPROC           create_shader;
+    PFNGLDELETESHADERPROC           delete_shader;
+    PFNGLSHADERSOURCEPROC           shader_source;
+    PFNGLCOMPILESHADERPROC          compile_shader;
+    PFNGLGETSHADERIVPROC            get_shader_iv;
+    PFNGLCREATEPROGRAMPROC          create_program;
+    PFNGLDELETEPROGRAMPROC          delete_program;
+    PFNGLATTACHSHADERPROC           attach_shader;
+    PFNGLBINDATTRIBLOCATIONPROC     bind_attrib_location;
+    PFNGLLINKPROGRAMPROC            link_program;
+    PFNGLGETPROGRAMIVPROC           get_program_iv;
+    PFNGLUSEPROGRAMPROC             use_program;
+    PFNGLENABLEVERTEXATTRIBARRAYPROC  enable_vertex_attrib_array;
+    PFNGLDISABLEVERTEXATTRIBARRAYPROC disable_vertex_attrib_array;
+    PFNGLVERTEXATTRIBPOINTERPROC    vertex_attrib_pointer;
+
+    // Instancing
+    PFNGLDRAWARRAYSINSTANCEDARBPROC draw_arrays_instanced;
+    PFNGLVERTEXATTRIBDIVISORARBPROC vertex_attrib_divisor;
+
+    // Fences
+    PFNGLFENCESYNCPROC       fence_sync;
+    PFNGLCLIENTWAITSYNCPROC  client_wait_sync;
+    PFNGLDELETESYNCPROC      delete_sync;
+
+    // Timer queries
+    PFNGLGENQUERIESPROC          gen_queries;
+    PFNGLDELETEQUERIESPROC       delete_queries;
+    PFNGLGETQUERYIVPROC          get_query_iv;
+    PFNGLQUERYCOUNTERPROC        query_counter;
+    PFNGLGETQUERYOBJECTIVPROC    get_query_object_iv;
+    PFNGLGETQUERYOBJECTUI64VPROC get_query_object_ui64v;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // Fetching a single function from the driver
+    static void* load(const char* name);
+
+// ------------------------------------------------------------ //
+
+private:
+    std::string m_extensions;
+    int m_major;
+    int m_minor;
+}; // GLExtensions
+
+END_NAMESPACE
+
+#endif // GLEXTENSIONS_HPP
\ No newline at end of file
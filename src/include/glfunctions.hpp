@@ -13,10 +13,17 @@
 
 #include "utils/utils.hpp"
 #include "utils/color.hpp"
+#include "utils/matrix.hpp"
 #include "draws/rectangle.hpp"
 #include "draws/circle.hpp"
 #include "draws/shape.hpp"
 #include "draws/sprite.hpp"
+#include "instance_renderer.hpp"
+#include "draw_list.hpp"
+
+#include <vector>
+#include <memory>
+#include <string>
 
 #ifdef _WIN32
 #include "windows/renderer.hpp"
@@ -29,7 +36,22 @@ START_NAMESPACE
 class GLFunctions
 {
 public:
+    // How the shapes are going to be drawn
+    enum class Mode
+    {
+        // Every draw is sent to OpenGL right away
+        Immediate,
+        // Every draw is appended into a vertex stream
+        // that is submitted on swap_buffers, the software
+        // backend is always drawing this way
+        Batched
+    }; // Mode
+
+    // ------------------------------------------------------------ //
+
     GLFunctions(Renderer& renderer);
+    GLFunctions(Renderer& renderer, Mode mode);
+    ~GLFunctions();
 
     // ------------------------------------------------------------ //
 
@@ -54,8 +76,83 @@ public:
 
     // ------------------------------------------------------------ //
 
+    // Drawing a lot of shapes at once, only the position, size,
+    // color and transform of every shape is sent to the GPU.
+    // If the context doesn't support instancing the shapes
+    // are batched instead.
+    void draw_instanced(const std::vector<Rectangle>& rects);
+    void draw_instanced(const std::vector<Circle>& circles);
+
+    // ------------------------------------------------------------ //
+
+    // Drawing lists that were recorded on other threads, in the
+    // order they are given. The lists must not be recorded while
+    // they are submitted, and they are not cleared by it
+    void submit(const DrawList& list);
+    void submit(const std::vector<DrawList>& lists);
+
+    // ------------------------------------------------------------ //
+
+    // The transform stack, every shape that is drawn after a push
+    // is transformed by the pushed transform as well (after its own),
+    // it's used to draw shapes that are attached to other shapes.
+    // start() is clearing the stack.
+    void push_transform(const Transformation& transformation);
+    void push_transform(const Matrix& matrix);
+    void pop_transform();
+
+    // The transform that is applied on every shape right now
+    const Matrix& get_transform() const;
+
+    // ------------------------------------------------------------ //
+
+    // Changing the drawing mode, it's better to call it
+    // before start(), anything that was batched
+    // is submitted before the mode changes
+    void set_mode(Mode mode);
+    Mode get_mode() const;
+
+    // Submitting all of the batched shapes right away,
+    // this is being called from swap_buffers anyway
+    void flush();
+
+    // ------------------------------------------------------------ //
+
+    // Timing the draws between them as a group of the frame,
+    // only when the renderer has GPU timing on. The batched
+    // shapes are submitted first, so they are inside of the group
+    void begin_group(const std::string& label);
+    void end_group();
+
+    // ------------------------------------------------------------ //
+
+private:
+    // The matrix of a shape, including the transform stack
+    Matrix transform(const Transformation& transformation) const;
+
+    // True if the shapes are added into the batch, the
+    // software rasterizer is always drawing the batch
+    bool batching() const;
+
+    // Sending a transformed vertex in immediate mode
+    static void vertex(const Matrix& matrix, float x, float y) noexcept;
+
+    // Drawing with the instanced renderer, or falling
+    // back to the batch if it's not supported
+    template<typename T>
+    void draw_instanced_shapes(const std::vector<T>& shapes);
+
+// ------------------------------------------------------------ //
+
 private:
     Renderer& m_renderer;
+    Mode m_mode;
+
+    // The transform stack, the first matrix is always identity
+    std::vector<Matrix> m_transforms;
+
+    // Created on the first instanced draw
+    std::unique_ptr<InstanceRenderer> m_instancer;
 }; // GLFunctions
 
 END_NAMESPACE
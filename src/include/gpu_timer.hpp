@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the GPU timer, it's putting      //
+// timestamp queries around the frame and around groups  //
+// of draws, and reads them a few frames later without   //
+// waiting for the GPU, next to the times of the CPU.    //
+///////////////////////////////////////////////////////////
+
+#ifndef GPU_TIMER_HPP
+#define GPU_TIMER_HPP
+
+#include "utils/utils.hpp"
+#include "glextensions.hpp"
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <cstdint>
+
+START_NAMESPACE
+
+class GPUTimer
+{
+public:
+    // The amount of frames that can wait for their
+    // queries, a frame is skipped if all of them are waiting
+    static constexpr size_t FRAMES = 4;
+
+    // A group of draws inside of a frame
+    struct Group
+    {
+        std::string label;
+
+        // The amount of groups it's inside of
+        unsigned int depth;
+
+        // How long the GPU was drawing the group, and how
+        // long the CPU was submitting it, in milliseconds
+        double gpu_ms;
+        double cpu_ms;
+    }; // Group
+
+    // A frame from begin_frame to end_frame
+    struct Frame
+    {
+        unsigned long number;
+        double gpu_ms;
+        double cpu_ms;
+
+        // In the order they were started
+        std::vector<Group> groups;
+    }; // Frame
+
+    // ------------------------------------------------------------ //
+
+    // Creating the queries on the current context
+    GPUTimer();
+    ~GPUTimer();
+
+    GPUTimer(const GPUTimer&) = delete;
+    GPUTimer& operator=(const GPUTimer&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Returns false if the context has no timestamp queries,
+    // in this case nothing is timed and poll never returns a frame
+    bool is_available() const;
+
+    // ------------------------------------------------------------ //
+
+    // Everything between them is a single frame, a frame that
+    // was started before the last one ended is thrown away
+    void begin_frame();
+    void end_frame();
+
+    // Groups can be inside of other groups, they are
+    // ignored outside of a frame
+    void begin_group(const std::string& label);
+    void end_group();
+
+    // ------------------------------------------------------------ //
+
+    // Takes the oldest frame that the GPU is done with,
+    // it never waits, returns false if no frame is ready.
+    // Only the last FRAMES frames are kept until they are taken
+    bool poll(Frame& frame);
+
+    // The amount of frames that were not timed
+    // because every slot was still waiting
+    size_t get_skipped() const;
+
+    // The amount of frames that were thrown away
+    // because they were not taken in time
+    size_t get_dropped() const;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // A group that was started inside of the slot
+    struct Marker
+    {
+        std::string label;
+        unsigned int depth;
+        size_t begin;
+        size_t end;
+    }; // Marker
+
+    // The queries of a single frame
+    struct Slot
+    {
+        unsigned long number;
+
+        // A timestamp of the GPU and of the CPU
+        // for every stamp that was taken
+        std::vector<GLuint> queries;
+        std::vector<uint64_t> cpu;
+        size_t stamps;
+
+        std::vector<Marker> markers;
+    }; // Slot
+
+    // ------------------------------------------------------------ //
+
+    // Taking a timestamp on the GPU and on the
+    // CPU, returns its index inside of the slot
+    size_t stamp(Slot& slot);
+
+    // Reading every slot that the GPU is done with
+    void collect();
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    GLExtensions m_gl;
+    bool m_available;
+
+    // Used as a ring, from the oldest frame
+    Slot m_slots[FRAMES];
+    size_t m_first;
+    size_t m_count;
+
+    // The slot of the frame that is being recorded
+    bool m_recording;
+    std::vector<size_t> m_open_groups;
+
+    std::deque<Frame> m_ready;
+    unsigned long m_next_frame;
+    size_t m_skipped;
+    size_t m_dropped;
+}; // GPUTimer
+
+END_NAMESPACE
+
+#endif // GPU_TIMER_HPP
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the image loader, images are     //
+// decoded on worker threads so the window threads never //
+// wait for them, only the upload into OpenGL is left    //
+// for the window thread.                                //
+///////////////////////////////////////////////////////////
+
+#ifndef IMAGE_LOADER_HPP
+#define IMAGE_LOADER_HPP
+
+#include "utils/utils.hpp"
+#include "utils/geometry.hpp"
+
+#include <vector>
+#include <string>
+#include <future>
+#include <memory>
+
+START_NAMESPACE
+
+class ImageLoader
+{
+public:
+    // This class does not need to be initialized.
+    // Users need to access it's functions directly
+    // because all of the functions are static
+    ImageLoader() = delete;
+
+    // ------------------------------------------------------------ //
+
+    // The RGBA pixels of an image, 4 bytes for every pixel
+    struct Image
+    {
+        std::vector<unsigned char> pixels;
+        Geometry size;
+
+        // False if the image couldn't be decoded
+        bool is_valid() const noexcept {
+            return !pixels.empty();
+        }
+    }; // Image
+
+    typedef std::shared_future<std::shared_ptr<const Image>> Result;
+
+    // ------------------------------------------------------------ //
+
+    // Decoding the image on one of the workers, loading a path
+    // that is already being decoded returns the same result
+    static Result load(const std::string& path);
+
+    // Decoding the image on the calling thread
+    static std::shared_ptr<const Image> decode(const std::string& path);
+
+    // ------------------------------------------------------------ //
+
+    // Changing the amount of workers, the images that are already
+    // decoded by the last workers are finished first.
+    // By default it's the amount of hardware threads
+    static void set_workers(size_t workers);
+    static size_t get_workers();
+}; // ImageLoader
+
+END_NAMESPACE
+
+#endif // IMAGE_LOADER_HPP
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains a single input event, the        //
+// renderer is keeping every event that happened in a    //
+// queue until the user takes it.                        //
+///////////////////////////////////////////////////////////
+
+#ifndef INPUT_EVENT_HPP
+#define INPUT_EVENT_HPP
+
+#include "utils/utils.hpp"
+#include "utils/vector.hpp"
+
+#include <chrono>
+
+START_NAMESPACE
+
+struct InputEvent
+{
+    enum class Type
+    {
+        // The names are not the same as the X11 macros
+        KeyPressed, KeyReleased,
+        ButtonPressed, ButtonReleased,
+        Scroll, Motion
+    }; // Type
+
+    Type type;
+
+    // The key for key events, the same values as Keyboard::Key.
+    // The button for button events, the same values as Mouse::Button
+    unsigned int code;
+
+    // The key is held and this press was repeated by the system
+    bool repeat;
+
+    // The mouse position on the window when it happened
+    VectorI position;
+
+    // Scroll steps, x is horizontal and y is vertical (up is positive)
+    VectorI scroll;
+
+    // When the event was taken from the system
+    std::chrono::steady_clock::time_point time;
+
+    // ------------------------------------------------------------ //
+
+    InputEvent()
+        : type(Type::Motion), code(0), repeat(false), position(0, 0), scroll(0, 0) {}
+    InputEvent(Type type_, unsigned int code_, const VectorI& position_)
+        : type(type_), code(code_), repeat(false), position(position_), scroll(0, 0),
+          time(std::chrono::steady_clock::now()) {}
+}; // InputEvent
+
+END_NAMESPACE
+
+#endif // INPUT_EVENT_HPP
@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the instanced renderer, a unit   //
+// quad and a unit circle are uploaded once to the GPU,  //
+// and only the position, size, color and transform of   //
+// every shape is streamed on every frame.               //
+///////////////////////////////////////////////////////////
+
+#ifndef INSTANCE_RENDERER_HPP
+#define INSTANCE_RENDERER_HPP
+
+#include "utils/utils.hpp"
+#include "glextensions.hpp"
+#include "utils/matrix.hpp"
+#include "utils/color.hpp"
+
+#include <vector>
+#include <map>
+
+START_NAMESPACE
+
+// Forward Declaration
+class Rectangle;
+class Circle;
+
+class InstanceRenderer
+{
+public:
+    // Creating the shaders and the meshes on the current context
+    InstanceRenderer();
+    ~InstanceRenderer();
+
+    InstanceRenderer(const InstanceRenderer&) = delete;
+    InstanceRenderer& operator=(const InstanceRenderer&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Returns false if the context cannot draw instances,
+    // in this case nothing is going to be drawn
+    bool is_supported() const;
+
+    // ------------------------------------------------------------ //
+
+    // Drawing all of the shapes, the filled and outlined
+    // shapes are drawn in the same order they were given.
+    // The parent is applied after the transform of every shape
+    void draw(const std::vector<Rectangle>& rects, const Matrix& parent);
+    void draw(const std::vector<Circle>& circles, const Matrix& parent);
+
+    // ------------------------------------------------------------ //
+
+private:
+    // Everything that is different between two shapes
+    struct Instance
+    {
+        float x, y;          // Position
+        float width, height; // Size or radius
+        float tx, ty;        // Translate
+        float sx, sy;        // Scale
+        float degree;        // Rotation
+        Color color;
+    }; // Instance
+
+    // A range of a unit mesh buffer
+    struct Mesh
+    {
+        GLuint buffer;
+        GLenum mode;
+        GLint first;
+        GLsizei count;
+    }; // Mesh
+
+    // ------------------------------------------------------------ //
+
+    // Compiling and linking the shaders
+    bool create_program();
+
+    // Returns the buffer of a unit circle, the filled triangle fan
+    // comes first and then the outline, every buffer is uploaded once
+    GLuint circle_buffer(int segments);
+
+    // Uploading the instances and drawing every run of
+    // shapes that are using the same mesh
+    void submit(const Mesh& fill, const Mesh& outline, const Matrix& parent);
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    GLExtensions m_gl;
+    bool m_supported;
+
+    GLuint m_program;
+    GLuint m_quad_buffer;
+    GLuint m_instance_buffer;
+
+    // Unit circles by the amount of segments
+    std::map<int, GLuint> m_circle_buffers;
+
+    // Reused on every frame
+    std::vector<Instance> m_instances;
+    std::vector<bool> m_fills;
+}; // InstanceRenderer
+
+END_NAMESPACE
+
+#endif // INSTANCE_RENDERER_HPP
\ No newline at end of file
@@ -64,10 +64,28 @@ public:
 
     // ------------------------------------------------------------ //
 
-    // Returns true if a key was pressed
+    // Returns true if a key was pressed, every call is asking
+    // the X server through a single shared connection, so the
+    // renderer functions below are much cheaper
     static bool key_pressed(Key key);
     // Has an option for ascii codes
     static bool key_pressed(unsigned int key);
+
+    // ------------------------------------------------------------ //
+
+    // These are answered from the keys that the renderer is
+    // fetching once every frame, when is_running is called.
+    // Returns true as long as the key is held
+    static bool key_pressed(Renderer& renderer, Key key);
+    static bool key_pressed(Renderer& renderer, unsigned int key);
+
+    // Returns true only on the frame the key went down
+    static bool key_down(Renderer& renderer, Key key);
+    static bool key_down(Renderer& renderer, unsigned int key);
+
+    // Returns true only on the frame the key went up
+    static bool key_released(Renderer& renderer, Key key);
+    static bool key_released(Renderer& renderer, unsigned int key);
 }; // Keyboard
 
 END_NAMESPACE
@@ -18,6 +18,7 @@
 #include "../utils/utils.hpp"
 #include "../utils/geometry.hpp"
 #include "../parent_renderer.hpp"
+#include "../share_group.hpp"
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
@@ -27,6 +28,9 @@
 
 #include <GL/glx.h>
 
+#include <vector>
+#include <cstdint>
+
 START_NAMESPACE
 
 class Renderer : public ParentRenderer
@@ -35,6 +39,13 @@ public:
     // Constructors
     explicit Renderer(const Geometry& geometry);
     explicit Renderer(unsigned int width, unsigned int height);
+    Renderer(const Geometry& geometry, Backend backend);
+    Renderer(unsigned int width, unsigned int height, Backend backend);
+
+    // The textures and buffers of the window are shared with every
+    // other window of the group, nullptr is not sharing them
+    Renderer(const Geometry& geometry, Backend backend, ShareGroup* group);
+    Renderer(unsigned int width, unsigned int height, Backend backend, ShareGroup* group);
     ~Renderer();
 
 
@@ -55,11 +66,20 @@ public:
 
     bool is_running() override;
 
+// ------------------------------------------------------------ //
+
+    bool set_swap_interval(int interval) override;
+
+// ------------------------------------------------------------ //
+
+    void make_current() override;
+    void release_current() override;
+
 // ------------------------------------------------------------ //
 
 private:
     // Calling all of the creation functions
-    void create() noexcept;
+    void create(Backend backend) noexcept;
 
     // Initialize all of the class members
     void init_members() noexcept;
@@ -67,12 +87,37 @@ private:
     // Creates an OpenGL context
     void create_opengl_context() noexcept;
 
+    // Finding the extension that is setting the swap
+    // interval, and the one that is counting vertical blanks
+    void init_swap_control() noexcept;
+
+    // Creates a plain window and the image that the
+    // software rasterizer is copied into
+    void create_software_window() noexcept;
+
+    // Creates the rasterizer of the software backends
+    void create_software_renderer() noexcept;
+
+    // Creates an offscreen OpenGL context without an X server,
+    // returns false if there is no such context
+    bool create_headless_context() noexcept;
+
+    // Copying the frame of the software rasterizer into the window
+    void present_software() noexcept;
+
     // Initializing all of the events and open the window
     void init_events() noexcept;
 
     // Handle all of the events
     void handle_events() noexcept;
 
+    // Adding the mouse and keyboard events into the events queue
+    void handle_button(const XButtonEvent& button) noexcept;
+    void handle_key(XKeyEvent& key) noexcept;
+
+    // Fetching the state of every key once for the whole frame
+    void update_keymap() noexcept;
+
 // ------------------------------------------------------------ //
 
 // Let the user access all of the members if he wants to
@@ -89,19 +134,54 @@ private:
     Screen*  screen;
     int screen_id;
 
-    // These are changing the window context to OpenGL
+    // These are changing the window context to OpenGL,
+    // they are nullptr for the software backend
     XVisualInfo* vi;
     GLXContext context;
 
+    // The software backend is putting this image into the window
+    XImage* image;
+    GC graphics_context;
+
+    // The EGL display, surface and context of a headless window,
+    // nullptr if there is no offscreen OpenGL context
+    void* egl_display;
+    void* egl_surface;
+    void* egl_context;
+
     // Events handler
     XEvent ev;
 
+    // The group the context is shared with, or nullptr
+    ShareGroup* share_group;
+
 private: // This is never being accessed no matter what
     // This is the mouse handlers that fetched from the
     // window events handler
     VectorI mouse_pos; 
     unsigned int button_pressed;
 
+    // The keys of this frame and the last frame, a bit for
+    // every keycode exactly like XQueryKeymap returns them
+    char keymap[32];
+    char last_keymap[32];
+
+    // The pixels of the image, and where every channel
+    // is inside of a pixel of the window
+    std::vector<uint32_t> image_pixels;
+    int red_shift, green_shift, blue_shift;
+
+    // Only one of the swap control extensions is loaded,
+    // the other ones are nullptr
+    PFNGLXSWAPINTERVALEXTPROC     swap_interval_ext;
+    PFNGLXSWAPINTERVALMESAPROC    swap_interval_mesa;
+    PFNGLXGETSWAPINTERVALMESAPROC get_swap_interval_mesa;
+    PFNGLXSWAPINTERVALSGIPROC     swap_interval_sgi;
+    bool adaptive_swap;
+
+    // Counting the vertical blanks, nullptr if it's not supported
+    PFNGLXGETSYNCVALUESOMLPROC get_sync_values;
+
     friend class Mouse;
     friend class Keyboard;
     friend class GLFunctions;
@@ -3,9 +3,21 @@
 
 #include "utils/utils.hpp"
 #include "utils/geometry.hpp"
+#include "batch.hpp"
+#include "software_rasterizer.hpp"
+#include "gpu_timer.hpp"
+#include "input_event.hpp"
+#include "utils/ring_buffer.hpp"
+#include "utils/frame_limiter.hpp"
+#include "utils/mpsc_queue.hpp"
 
 #include <chrono>
 #include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
 
 START_NAMESPACE
 
@@ -15,6 +27,56 @@ class Renderer;
 class ParentRenderer
 {
 public:
+    // What is drawing the shapes of the window
+    enum class Backend
+    {
+        // The OpenGL context of the window
+        OpenGL,
+        // The software rasterizer, the frame is drawn on the
+        // CPU and it's copied into the window on swap_buffers
+        Software,
+        // Without a window or an X server, it's drawing into an
+        // offscreen OpenGL context, or with the software rasterizer
+        // if there is no such context. The frame is kept on swap_buffers
+        Headless,
+        // Same as above, but always with the software rasterizer
+        HeadlessSoftware
+    }; // Backend
+
+    // The timing of the frames since the window was
+    // created, or since the last reset_frame_stats
+    struct FrameStats
+    {
+        // The amount of frames that were swapped
+        unsigned long frames;
+
+        // From the last swap_buffers to the one before it,
+        // and the average of all of them, in milliseconds
+        double last_frame_ms;
+        double average_frame_ms;
+
+        // The swap interval the driver is using
+        int swap_interval;
+
+        // The average amount of vertical blanks between two swaps,
+        // and the refresh rate of the screen. Both of them are 0
+        // if the driver cannot count the vertical blanks
+        double achieved_interval;
+        double refresh_rate;
+
+        // The frames that ended after their deadline while the
+        // frame rate was limited, and the latest one of them
+        unsigned long missed_deadlines;
+        double worst_late_ms;
+    }; // FrameStats
+
+// ------------------------------------------------------------ //
+
+    ParentRenderer();
+    virtual ~ParentRenderer() = default;
+
+// ------------------------------------------------------------ //
+
     // This function is being called every tick
     virtual void on_update() = 0;
 
@@ -56,11 +118,116 @@ public:
     // Returning the framerate in ms
     double get_framerate() const;
 
+// ------------------------------------------------------------ //
+
+    // Waiting for this amount of vertical blanks on every swap_buffers,
+    // 0 is never waiting and -1 is adaptive, it's only waiting if the
+    // frame was not late. It has to be called from the thread of the
+    // window, returns false if the driver cannot do it
+    virtual bool set_swap_interval(int interval) = 0;
+
+    // The extension that is setting the swap interval,
+    // empty if there is no such extension
+    const std::string& get_swap_control() const;
+
+    const FrameStats& get_frame_stats() const;
+    void reset_frame_stats();
+
+// ------------------------------------------------------------ //
+
+    // Limiting the amount of on_update calls every second,
+    // 0 is calling it as fast as possible
+    void set_target_fps(double fps);
+    double get_target_fps() const;
+
+    // Called by the loop of the window after every on_update,
+    // it's waiting until the next frame has to start
+    void wait_for_next_frame();
+
+    // Like wait_for_next_frame without waiting, returns when
+    // the next frame has to start in FrameLimiter::now time
+    int64_t schedule_next_frame();
+
+// ------------------------------------------------------------ //
+
+    // Making the context of the window current on the calling
+    // thread, so the window can be drawn from another thread.
+    // The window cannot be current on two threads at once
+    virtual void make_current() = 0;
+    virtual void release_current() = 0;
+
 // ------------------------------------------------------------ //
 
     // Returning if the current window is active
     bool is_focused() const;
 
+// ------------------------------------------------------------ //
+
+    // The backend that is drawing the window, a headless
+    // window is either OpenGL or Software
+    Backend get_backend() const;
+
+    // The rasterizer of the software backend, it's holding the
+    // last frame that was drawn. nullptr for the OpenGL backend
+    const SoftwareRasterizer* get_rasterizer() const;
+
+// ------------------------------------------------------------ //
+
+    // True if the window was created with one of the headless
+    // backends, it has no input events and nothing is displayed
+    bool is_headless() const;
+
+    // The last frame that a headless window swapped, from the
+    // top row to the bottom row. Empty if nothing was captured
+    const std::vector<Color>& get_frame() const;
+
+    // Reading every frame back on swap_buffers, it's on by default.
+    // Turning it off is letting an OpenGL headless window draw
+    // at full speed when nobody needs the pixels
+    void set_capture(bool capture);
+
+    // Writing the last frame as a binary PPM file, returns false
+    // if there is no frame or the file couldn't be written
+    bool save_frame(const std::string& path) const;
+
+    // Writing every frame on swap_buffers into <prefix>000000.ppm,
+    // <prefix>000001.ppm and so on, an empty prefix stops writing
+    void set_frame_output(const std::string& prefix);
+
+// ------------------------------------------------------------ //
+
+    // Timing every frame from GLFunctions::start to swap_buffers
+    // on the GPU, it has to be called from the thread of the window.
+    // Returns false if the context has no timer queries, the
+    // software backend never has them
+    bool set_gpu_timing(bool enabled);
+
+    // Takes the oldest frame that was timed, it never waits
+    // for the GPU, returns false if no frame is ready yet
+    bool poll_gpu_timing(GPUTimer::Frame& frame);
+
+// ------------------------------------------------------------ //
+
+    // Takes the oldest input event that was not taken yet, the
+    // events are added by is_running, returns false if there
+    // are no more events. It can be called from another thread
+    // as long as only one thread is taking the events
+    bool poll_event(InputEvent& event);
+
+    // The amount of events that were lost because
+    // the user didn't take them fast enough
+    size_t get_dropped_events() const;
+
+// ------------------------------------------------------------ //
+
+    // Running the task on the thread of the window at the start of
+    // the next is_running, it can be called from any thread without
+    // locking. Returns false if too many tasks are waiting already
+    bool post(std::function<void()> task);
+
+    // The amount of tasks that post didn't accept
+    size_t get_rejected_posts() const;
+
 // ------------------------------------------------------------ //
 
 // Let the user access all of the members if he wants to
@@ -89,6 +256,61 @@ protected:
     
     // Threading support
     std::atomic<bool> focused;
+
+    // All of the shapes that were drawn in batched mode
+    // and are waiting to be submitted on swap_buffers
+    Batch m_batch;
+
+    // Every input event since the user took the last one
+    static constexpr size_t MAX_EVENTS = 512;
+    RingBuffer<InputEvent, MAX_EVENTS> m_events;
+    std::atomic<size_t> m_dropped_events;
+
+    // Called from the events handler
+    void push_event(const InputEvent& event);
+
+    // The tasks that were posted by other threads
+    static constexpr size_t MAX_POSTED = 1024;
+    MPSCQueue<std::function<void()>, MAX_POSTED> m_posted;
+    std::atomic<size_t> m_rejected_posts;
+
+    // Called by is_running, the tasks that are posted while
+    // it's running are waiting for the next frame
+    void run_posted();
+
+    // Only created for the software backend
+    std::unique_ptr<SoftwareRasterizer> m_software;
+
+    // Drawing everything that was batched with OpenGL
+    // or with the software rasterizer
+    void flush_batch();
+
+    // Everything a headless window is doing with its frames
+    bool m_headless;
+    bool m_capture;
+    std::vector<Color> m_frame;
+    std::string m_frame_output;
+    unsigned long m_frame_number;
+
+    // Called by swap_buffers of a headless window
+    void capture_frame();
+
+    // Only created while GPU timing is on
+    std::unique_ptr<GPUTimer> m_gpu_timer;
+
+    // Set by the renderer when the context is created
+    std::string m_swap_control;
+
+    FrameStats m_frame_stats;
+    std::chrono::steady_clock::time_point m_last_swap;
+    int64_t m_first_vblank;
+
+    // Called after every swap_buffers with the vertical blank
+    // counter of the screen, or -1 if it cannot be counted
+    void record_swap(int64_t vblank);
+
+    FrameLimiter m_limiter;
+    void record_missed_deadline();
 }; // ParentRenderer
 
 END_NAMESPACE
@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the pixel reader, it's reading   //
+// regions of the window into a ring of pixel buffers    //
+// without waiting for the GPU, the pixels are taken a   //
+// frame or two later, and many single pixels can be     //
+// read at once with a single read.                      //
+///////////////////////////////////////////////////////////
+
+#ifndef PIXEL_READER_HPP
+#define PIXEL_READER_HPP
+
+#include "utils/utils.hpp"
+#include "utils/vector.hpp"
+#include "utils/geometry.hpp"
+#include "utils/color.hpp"
+#include "glextensions.hpp"
+
+#include <vector>
+#include <deque>
+
+START_NAMESPACE
+
+// Forward Declaration
+class Renderer;
+
+class PixelReader
+{
+public:
+    // The amount of pixel buffers, a region that is requested
+    // every frame is usually ready two frames later
+    static constexpr size_t BUFFERS = 3;
+
+    // A part of the window that was read
+    struct Region
+    {
+        unsigned long ticket;
+        VectorUI position;
+        Geometry size;
+
+        // From the top row to the bottom row
+        std::vector<Color> pixels;
+
+        // The position is relative to the region
+        Color get_pixel(unsigned int x, unsigned int y) const;
+    }; // Region
+
+    // ------------------------------------------------------------ //
+
+    // Creating the buffers on the current context, the
+    // renderer has to be the window of the context.
+    // Nothing is created for the software rasterizer
+    explicit PixelReader(const Renderer& renderer);
+    ~PixelReader();
+
+    PixelReader(const PixelReader&) = delete;
+    PixelReader& operator=(const PixelReader&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Returns false if the context has no pixel buffers or the
+    // window is using the software rasterizer, in this case
+    // every request is read right away
+    bool is_async() const;
+
+    // ------------------------------------------------------------ //
+
+    // Starting to read a region of the window, or all of it, and
+    // returns the ticket of the region. It has to be called after
+    // drawing and before swap_buffers, in batched mode the shapes
+    // have to be flushed first. The region is clipped to the window
+    unsigned long request(const VectorUI& position, const Geometry& size);
+    unsigned long request();
+
+    // Takes the oldest region that was read, it never waits for
+    // the GPU, returns false if no region is ready yet
+    bool poll(Region& region);
+
+    // Same as above, but waits for the oldest region if it's not
+    // ready yet, returns false only if nothing was requested
+    bool wait(Region& region);
+
+    // The amount of regions that were not taken yet
+    size_t get_pending() const;
+
+    // ------------------------------------------------------------ //
+
+    // Reading many pixels with a single read of the rectangle that
+    // is around all of them, it waits for the GPU only once.
+    // Points outside of the window are black
+    void read(const std::vector<VectorUI>& points, std::vector<Color>& colors);
+
+    // ------------------------------------------------------------ //
+
+private:
+    // A pixel buffer and the region that is being read into it
+    struct Slot
+    {
+        GLuint buffer;
+        size_t capacity;
+        GLsync fence;
+        Region region;
+    }; // Slot
+
+    // ------------------------------------------------------------ //
+
+    // Clipping the region to the window, returns false if
+    // nothing is left of it
+    bool clip(VectorUI& position, Geometry& size) const;
+
+    // Reading the region right away, waiting for the GPU
+    void read_pixels(Region& region) const;
+
+    // True if the GPU is done with the oldest slot
+    bool is_ready(const Slot& slot) const;
+
+    // Copying the oldest slot into the ready regions
+    void complete();
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    const Renderer& m_renderer;
+    GLExtensions m_gl;
+    bool m_async;
+
+    // Used as a ring, from the oldest request
+    Slot m_slots[BUFFERS];
+    size_t m_first;
+    size_t m_count;
+
+    // Regions that were copied and were not taken yet
+    std::deque<Region> m_ready;
+    unsigned long m_next_ticket;
+}; // PixelReader
+
+END_NAMESPACE
+
+#endif // PIXEL_READER_HPP
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the frame profiler, the scoped   //
+// zones are timing parts of the frame into a ring       //
+// buffer of every thread without locking, and all of    //
+// them can be written as a Chrome trace. The zones are  //
+// only compiled when GFX_PROFILE is defined:            //
+// #define GFX_PROFILE                                   //
+///////////////////////////////////////////////////////////
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "utils/utils.hpp"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+START_NAMESPACE
+
+class Profiler
+{
+public:
+    // The amount of zones every thread can keep
+    // until they are collected, the newer ones are dropped
+    static constexpr size_t ZONES_PER_THREAD = 1 << 16;
+
+    // A part of the frame that was timed, the times are in
+    // nanoseconds since the first zone of the process.
+    // The name has to live forever, like a string literal
+    struct Zone
+    {
+        const char* name;
+        uint64_t begin;
+        uint64_t end;
+    }; // Zone
+
+    // A zone that was collected and the thread it was timed on
+    struct Record
+    {
+        Zone zone;
+        uint32_t thread;
+    }; // Record
+
+    // ------------------------------------------------------------ //
+
+    // The zones are recorded by default, disabling them is leaving
+    // only a single check in every zone
+    static void set_enabled(bool enabled);
+    static bool is_enabled();
+
+    // ------------------------------------------------------------ //
+
+    // Nanoseconds since the first zone of the process
+    static uint64_t now();
+
+    // Adding a zone into the ring buffer of the calling thread
+    static void record(const char* name, uint64_t begin, uint64_t end);
+
+    // The name of the calling thread inside of the trace
+    static void set_thread_name(const std::string& name);
+
+    // ------------------------------------------------------------ //
+
+    // Taking the zones of every thread, it can be called while the
+    // other threads are recording, but only from a single thread
+    // at a time. Returns the amount of zones that were taken
+    static size_t collect();
+
+    // Every zone that was collected, oldest first for every thread
+    static const std::vector<Record>& get_records();
+
+    // Removing every zone that was collected
+    static void clear();
+
+    // The amount of zones that were lost because
+    // a ring buffer was full
+    static size_t get_dropped();
+
+    // ------------------------------------------------------------ //
+
+    // Collecting and writing every zone as a Chrome trace, it can be
+    // opened with chrome://tracing or with Perfetto. The records are
+    // kept, so a trace can be written more than once
+    static void write_chrome_trace(std::ostream& stream);
+    static bool write_chrome_trace(const std::string& path);
+}; // Profiler
+
+// ------------------------------------------------------------ //
+
+// Timing the scope it was created in
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name)
+        : m_name(name), m_enabled(Profiler::is_enabled()), m_begin(m_enabled ? Profiler::now() : 0) {}
+
+    ~ProfileZone()
+    {
+        if(m_enabled)
+            Profiler::record(m_name, m_begin, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    bool m_enabled;
+    uint64_t m_begin;
+}; // ProfileZone
+
+END_NAMESPACE
+
+// ------------------------------------------------------------ //
+
+// Every zone of the library and of the user is using this
+// macro, so without GFX_PROFILE there is nothing to time
+#ifdef GFX_PROFILE
+#define GFX_PROFILE_JOIN_(lhs, rhs) lhs##rhs
+#define GFX_PROFILE_JOIN(lhs, rhs) GFX_PROFILE_JOIN_(lhs, rhs)
+#define GFX_PROFILE_ZONE(name) ::gfx::ProfileZone GFX_PROFILE_JOIN(gfx_profile_zone_, __LINE__)(name)
+#else
+#define GFX_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
+
+#endif // PROFILER_HPP
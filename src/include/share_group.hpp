@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the share group, the windows     //
+// that are created with the same group are sharing      //
+// their textures and buffers, so an image is decoded    //
+// and uploaded once for all of them.                    //
+///////////////////////////////////////////////////////////
+
+#ifndef SHARE_GROUP_HPP
+#define SHARE_GROUP_HPP
+
+#include "utils/utils.hpp"
+
+#include <vector>
+#include <mutex>
+
+START_NAMESPACE
+
+// Forward Declaration
+class Renderer;
+
+class ShareGroup
+{
+public:
+    // The group has to live longer than its windows
+    ShareGroup();
+    ~ShareGroup();
+
+    ShareGroup(const ShareGroup&) = delete;
+    ShareGroup& operator=(const ShareGroup&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // The amount of windows that are sharing the group right now,
+    // windows that couldn't share with it are not counted
+    size_t get_window_count() const;
+
+    // ------------------------------------------------------------ //
+
+    // What the texture cache is using instead of the context, it's
+    // the same for every context of a group. A context that is not
+    // in a group is returned as it is
+    static void* key_of(void* context);
+
+    // Returns true if the context is in a group, the other
+    // windows of it may be drawing on other threads
+    static bool is_shared(void* context);
+
+    // ------------------------------------------------------------ //
+
+private:
+    // Contexts of different APIs cannot share
+    enum class Api
+    {
+        GLX,
+        EGL,
+        WGL
+    }; // Api
+
+    // Called by the renderer while it's creating its context, the
+    // group is locked between them so the contexts are created one
+    // at a time. The context to share with is nullptr for the first
+    // context of the group, returns false if it cannot join at all
+    bool begin_join(Api api, void*& share);
+
+    // Adding the context that was created, nullptr if it
+    // couldn't be created or couldn't share
+    void end_join(void* context);
+
+    // Called before the context is destroyed, the textures
+    // are forgotten by the cache once every context left
+    void leave(void* context);
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    mutable std::mutex m_mutex;
+
+    Api m_api;
+    std::vector<void*> m_contexts;
+
+    // The first context of the group, the textures of the group
+    // are gone once every context left so a new key is used after
+    void* m_key;
+
+    friend class Renderer;
+}; // ShareGroup
+
+END_NAMESPACE
+
+#endif // SHARE_GROUP_HPP
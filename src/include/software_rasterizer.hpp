@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the software rasterizer, it's    //
+// drawing the batched triangles and lines into an RGBA  //
+// framebuffer without a GPU. The screen is split into   //
+// tiles and every thread is drawing whole tiles, so a   //
+// pixel is never written by two threads.                //
+///////////////////////////////////////////////////////////
+
+#ifndef SOFTWARE_RASTERIZER_HPP
+#define SOFTWARE_RASTERIZER_HPP
+
+#include "utils/utils.hpp"
+#include "utils/color.hpp"
+#include "utils/geometry.hpp"
+#include "utils/thread_pool.hpp"
+#include "batch.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+START_NAMESPACE
+
+class SoftwareRasterizer
+{
+public:
+    // The width and height of a tile in pixels
+    static constexpr int TILE_SIZE = 64;
+
+    // A texture that is kept on the CPU
+    struct Texture
+    {
+        Geometry size;
+        std::vector<Color> pixels;
+
+        // Repeating the texture coordinates, otherwise
+        // they are clamped to the edges
+        bool repeat;
+    }; // Texture
+
+    // ------------------------------------------------------------ //
+
+    // The calling thread is drawing tiles as well, so the
+    // workers are only the extra threads, it can be 0
+    explicit SoftwareRasterizer(const Geometry& size);
+    SoftwareRasterizer(const Geometry& size, size_t workers);
+
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // The rasterizer of the window that was created on this thread,
+    // nullptr if the window is using OpenGL. It's replacing the
+    // current OpenGL context for the textures
+    static SoftwareRasterizer* current();
+    static void make_current(SoftwareRasterizer* rasterizer);
+
+    // ------------------------------------------------------------ //
+
+    // Filling the whole framebuffer with a single color
+    void clear(const Color& color);
+
+    // Drawing every command of the batch in the same order
+    // Batch::flush is drawing them, the batch is not cleared
+    void draw(const Batch& batch);
+
+    // ------------------------------------------------------------ //
+
+    const Geometry& get_size() const;
+    size_t get_worker_count() const;
+
+    // From the top row to the bottom row
+    const Color* get_pixels() const;
+    Color get_pixel(unsigned int x, unsigned int y) const;
+
+    // ------------------------------------------------------------ //
+
+    // Textures are shared with every software window, the
+    // ids are never 0 exactly like OpenGL textures.
+    // The pixels of a new texture can be nullptr
+    static unsigned int create_texture(unsigned int width, unsigned int height, const Color* pixels, bool repeat);
+
+    // Replacing a part of the texture, row_length is the
+    // amount of colors in every row of the pixels
+    static void update_texture(unsigned int id, unsigned int x, unsigned int y,
+                               unsigned int width, unsigned int height,
+                               const Color* pixels, unsigned int row_length);
+
+    // Copying the texture, returns false if there is no such texture
+    static bool read_texture(unsigned int id, Texture& texture);
+
+    static void delete_texture(unsigned int id);
+
+    // ------------------------------------------------------------ //
+
+private:
+    // A triangle or a line of the batch
+    struct Primitive
+    {
+        const BatchVertex* vertices;
+        const Texture* texture;
+        bool line;
+    }; // Primitive
+
+    // A rectangle of pixels, the right and bottom are not included
+    struct Bounds
+    {
+        int left, top, right, bottom;
+    }; // Bounds
+
+    // ------------------------------------------------------------ //
+
+    // Adding the primitive into every tile it's touching
+    void bin(uint32_t index, const Bounds& bounds);
+
+    // Drawing every primitive of a tile in order
+    void draw_tile(size_t tile);
+
+    void draw_triangle(const Primitive& primitive, const Bounds& tile);
+    void draw_line(const Primitive& primitive, const Bounds& tile);
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    Geometry m_size;
+    std::vector<Color> m_pixels;
+
+    // Created only if there are extra workers
+    std::unique_ptr<ThreadPool> m_pool;
+
+    // Reused on every draw
+    int m_tiles_x;
+    int m_tiles_y;
+    std::vector<Primitive> m_primitives;
+    std::vector<std::vector<uint32_t>> m_bins;
+    std::vector<std::shared_ptr<const Texture>> m_textures;
+}; // SoftwareRasterizer
+
+END_NAMESPACE
+
+#endif // SOFTWARE_RASTERIZER_HPP
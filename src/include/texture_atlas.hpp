@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the texture atlas, many images   //
+// are packed into a few big textures, so sprites that   //
+// are using the same atlas can be drawn together in a   //
+// single draw call.                                     //
+///////////////////////////////////////////////////////////
+
+#ifndef TEXTURE_ATLAS_HPP
+#define TEXTURE_ATLAS_HPP
+
+#include "utils/utils.hpp"
+#include "utils/vector.hpp"
+#include "utils/geometry.hpp"
+
+#include <vector>
+#include <string>
+
+START_NAMESPACE
+
+class TextureAtlas
+{
+public:
+    // The place of a single image inside the atlas
+    struct Region
+    {
+        unsigned int texture; // The page texture
+        VectorUI position;    // In pixels inside the page
+        Geometry size;        // The size of the image
+        VectorF uv_min;       // Top left texture coordinate
+        VectorF uv_max;       // Bottom right texture coordinate
+    }; // Region
+
+    // ------------------------------------------------------------ //
+
+    // Every page is a texture with this size, the
+    // pages are only created when images are added,
+    // so a context must be current when adding
+    explicit TextureAtlas(unsigned int width = 2048, unsigned int height = 2048);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Loading an image and packing it into the atlas, a new page
+    // is created if it doesn't fit in any of the pages.
+    // Throws if the image cannot be loaded or is bigger than a page
+    Region add(const std::string& path);
+
+    // Same as above with RGBA pixels, 4 bytes for every pixel
+    Region add(const unsigned char* pixels, unsigned int width, unsigned int height);
+
+    // ------------------------------------------------------------ //
+
+    // The amount of textures that were created
+    size_t get_page_count() const;
+    const Geometry& get_page_size() const;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // A segment of the top edge of everything that was packed
+    struct Skyline
+    {
+        unsigned int x, y, width;
+    }; // Skyline
+
+    struct Page
+    {
+        unsigned int texture;
+        std::vector<Skyline> skyline;
+    }; // Page
+
+    // ------------------------------------------------------------ //
+
+    // Returns true and the place with the lowest top edge where the
+    // rectangle can be placed, the index is the first skyline it covers
+    bool find(const Page& page, unsigned int width, unsigned int height,
+              size_t& index, VectorUI& position) const;
+
+    // Raising the skyline under the rectangle that was placed
+    void place(Page& page, size_t index, const VectorUI& position,
+               unsigned int width, unsigned int height);
+
+    // Creating an empty texture for a page
+    Page& create_page();
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    Geometry m_page_size;
+    std::vector<Page> m_pages;
+}; // TextureAtlas
+
+END_NAMESPACE
+
+#endif // TEXTURE_ATLAS_HPP
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the texture cache, every image   //
+// is decoded and uploaded once for every OpenGL context //
+// and all of the sprites that are using it are sharing  //
+// the same texture.                                     //
+///////////////////////////////////////////////////////////
+
+#ifndef TEXTURE_CACHE_HPP
+#define TEXTURE_CACHE_HPP
+
+#include "utils/utils.hpp"
+#include "utils/geometry.hpp"
+
+#include <string>
+#include <cstddef>
+
+START_NAMESPACE
+
+class TextureCache
+{
+public:
+    // This class does not need to be initialized.
+    // Users need to access it's functions directly
+    // because all of the functions are static
+    TextureCache() = delete;
+
+    // ------------------------------------------------------------ //
+
+    // A texture that was loaded by the cache
+    struct Texture
+    {
+        unsigned int id;
+        Geometry size;
+    }; // Texture
+
+    // How two images are known to be the same
+    enum class Key
+    {
+        Path,   // The same path
+        Content // The same file content, even with a different path
+    }; // Key
+
+    // ------------------------------------------------------------ //
+
+    // Returns the texture of the image on the current context, it's
+    // only loaded if it's not cached yet. Every acquire must have
+    // a release. Throws if the image cannot be loaded
+    static Texture acquire(const std::string& path);
+    static Texture acquire(const std::string& path, Key key);
+
+    // Same as above with pixels that were already decoded,
+    // they are only uploaded if the path is not cached yet
+    static Texture acquire(const std::string& path, const unsigned char* pixels, 
+                           unsigned int width, unsigned int height);
+
+    // Returns true and acquires the texture only
+    // if the path is already cached
+    static bool try_acquire(const std::string& path, Texture& texture);
+
+    // Uploading a texture that belongs only to the caller, it's never
+    // found by a path and it's deleted by its last release
+    static Texture create(const unsigned char* pixels, unsigned int width, unsigned int height);
+
+    // Returns true if the texture came from create and
+    // nothing else has a reference to it
+    static bool is_unique(unsigned int id);
+
+    // The key that acquire is using when it's not given
+    static void set_key(Key key);
+
+    // Adding and removing a reference of a texture on the current
+    // context, textures that are not from the cache are ignored
+    static void retain(unsigned int id);
+    static void release(unsigned int id);
+
+    // ------------------------------------------------------------ //
+
+    // Deleting every texture of the current context that is not
+    // used anymore, returns the amount of bytes that were freed
+    static size_t evict();
+
+    // Forgetting every texture of a context or of a share group
+    // without deleting them, they are gone with the context.
+    // Called right before the context is destroyed
+    static void drop_context(void* context);
+
+    // The memory of every cached texture on every context,
+    // 4 bytes for every pixel
+    static size_t get_memory_usage();
+    static size_t get_texture_count();
+}; // TextureCache
+
+END_NAMESPACE
+
+#endif // TEXTURE_CACHE_HPP
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains new and delete for types that    //
+// are aligned to a cache line, C++11 new is only        //
+// aligning to alignof(std::max_align_t).                //
+///////////////////////////////////////////////////////////
+
+#ifndef ALIGNED_HPP
+#define ALIGNED_HPP
+
+#include "utils.hpp"
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+START_NAMESPACE
+
+// The original pointer is kept right before the memory
+inline void* aligned_allocate(size_t size, size_t alignment)
+{
+    void* memory = ::operator new(size + alignment + sizeof(void*));
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory) + sizeof(void*);
+    address = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    reinterpret_cast<void**>(address)[-1] = memory;
+
+    return reinterpret_cast<void*>(address);
+}
+
+inline void aligned_deallocate(void* memory) {
+    ::operator delete(reinterpret_cast<void**>(memory)[-1]);
+}
+
+// ------------------------------------------------------------ //
+
+template<typename T>
+T* aligned_new()
+{
+    void* memory = aligned_allocate(sizeof(T), alignof(T));
+
+    try {
+        return new(memory) T;
+    }
+    catch(...) {
+        aligned_deallocate(memory);
+        throw;
+    }
+}
+
+// The pointer has to be of the type that was created
+template<typename T>
+void aligned_delete(T* object)
+{
+    if(!object)
+        return;
+
+    object->~T();
+    aligned_deallocate(object);
+}
+
+// For std::unique_ptr
+template<typename T>
+struct AlignedDeleter
+{
+    void operator()(T* object) const {
+        aligned_delete(object);
+    }
+}; // AlignedDeleter
+
+END_NAMESPACE
+
+#endif // ALIGNED_HPP
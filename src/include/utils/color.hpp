@@ -3,7 +3,8 @@
 // https://therealcain.github.io/website/                //
 ///////////////////////////////////////////////////////////
 // This header contains the color sRGBA, with a few      //
-// operator overloads.                                   //
+// operator overloads. The color is packed in 4 bytes so //
+// it can be given to OpenGL as it is.                   //
 ///////////////////////////////////////////////////////////
 
 #ifndef COLOR_HPP
@@ -12,6 +13,7 @@
 #include "utils.hpp"
 
 #include <iostream>
+#include <cstddef>
 
 START_NAMESPACE
 
@@ -22,11 +24,19 @@ private:
 
     // ------------------------------------------------------------ //
 
+    // Clamping a channel into a single byte
+    template<typename T>
+    static constexpr unsigned char clamp(T channel) {
+        return static_cast<unsigned char>(channel >= MAX_COLORS ? MAX_COLORS : channel);
+    }
+
+    // ------------------------------------------------------------ //
+
 public:
-    unsigned int r; // Red
-    unsigned int g; // Green
-    unsigned int b; // Blue
-    unsigned int a; // Alpha aka Opacity
+    unsigned char r; // Red
+    unsigned char g; // Green
+    unsigned char b; // Blue
+    unsigned char a; // Alpha aka Opacity
 
     // ------------------------------------------------------------ //
 
@@ -34,28 +44,29 @@ public:
     constexpr Color()
         : r(0), g(0), b(0), a(MAX_COLORS) {}
     constexpr Color(unsigned int red, unsigned int green, unsigned int blue)
-        : r(red   >= MAX_COLORS ? MAX_COLORS : red), 
-          g(green >= MAX_COLORS ? MAX_COLORS : green), 
-          b(blue  >= MAX_COLORS ? MAX_COLORS : blue), 
+        : r(clamp(red)), 
+          g(clamp(green)), 
+          b(clamp(blue)), 
           a(MAX_COLORS) {}
     constexpr Color(unsigned int red, unsigned int green, unsigned int blue, unsigned int alpha)
-        : r(red   >= MAX_COLORS ? MAX_COLORS : red), 
-          g(green >= MAX_COLORS ? MAX_COLORS : green), 
-          b(blue  >= MAX_COLORS ? MAX_COLORS : blue), 
-          a(alpha >= MAX_COLORS ? MAX_COLORS : alpha) {}
+        : r(clamp(red)), 
+          g(clamp(green)), 
+          b(clamp(blue)), 
+          a(clamp(alpha)) {}
 
     template<typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
     constexpr Color(T red, T green, T blue, T alpha)
-        : r(static_cast<unsigned int>(red   >= MAX_COLORS ? MAX_COLORS : red)), 
-          g(static_cast<unsigned int>(green >= MAX_COLORS ? MAX_COLORS : green)), 
-          b(static_cast<unsigned int>(blue  >= MAX_COLORS ? MAX_COLORS : blue)), 
-          a(static_cast<unsigned int>(alpha >= MAX_COLORS ? MAX_COLORS : alpha)) {}
+        : r(clamp(red)), 
+          g(clamp(green)), 
+          b(clamp(blue)), 
+          a(clamp(alpha)) {}
 
     template<typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
     constexpr Color(T red, T green, T blue)
-        : r(static_cast<unsigned int>(red   >= MAX_COLORS ? MAX_COLORS : red)), 
-          g(static_cast<unsigned int>(green >= MAX_COLORS ? MAX_COLORS : green)), 
-          b(static_cast<unsigned int>(blue  >= MAX_COLORS ? MAX_COLORS : blue)) {}
+        : r(clamp(red)), 
+          g(clamp(green)), 
+          b(clamp(blue)),
+          a(MAX_COLORS) {}
 
 
     // Copy Constructor
@@ -87,11 +98,28 @@ public:
     // Just to ease on printing the color
     inline friend std::ostream& operator<<(std::ostream& os, const Color& color) 
     {
-        os << "R = " << color.r << " , G = " << color.g << " , B = " << color.b << " , A = " << color.a;
+        os << "R = " << static_cast<unsigned int>(color.r) 
+           << " , G = " << static_cast<unsigned int>(color.g) 
+           << " , B = " << static_cast<unsigned int>(color.b) 
+           << " , A = " << static_cast<unsigned int>(color.a);
         return os;
     }
 };
 
+// The colors are given to OpenGL as GL_UNSIGNED_BYTE
+// arrays, so there must not be any padding
+static_assert(sizeof(Color) == 4, "Color must be packed into 4 bytes");
+
+// ------------------------------------------------------------ //
+
+// Converting arrays of colors into RGBA floats between 0 and 1
+// and back, 4 colors are converted at once with SSE2 or NEON.
+// The output must have room for count * 4 floats
+extern void colors_to_gl(const Color* colors, float* out, size_t count);
+
+// The floats are clamped between 0 and 1 and rounded
+extern void gl_to_colors(const float* colors, Color* out, size_t count);
+
 END_NAMESPACE
 
 #endif // COLOR_HPP
\ No newline at end of file
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the frame limiter, it's sleeping //
+// until right before the deadline of the next frame and //
+// spinning the rest of the way for a low jitter.        //
+///////////////////////////////////////////////////////////
+
+#ifndef FRAME_LIMITER_HPP
+#define FRAME_LIMITER_HPP
+
+#include "utils.hpp"
+
+#include <cstdint>
+
+START_NAMESPACE
+
+class FrameLimiter
+{
+public:
+    FrameLimiter();
+
+    // ------------------------------------------------------------ //
+
+    // The amount of frames per second, 0 is never waiting
+    void set_target(double fps);
+    double get_target() const;
+
+    // ------------------------------------------------------------ //
+
+    // Moving to the deadline of the next frame without waiting,
+    // returns false if the deadline was already missed, in this
+    // case the next deadline starts from now
+    bool advance();
+
+    // Advancing and waiting until the deadline
+    bool wait();
+
+    // The deadline of the frame, in the time of now(). Without
+    // a target it's the time of the last advance
+    int64_t get_deadline() const;
+
+    // How late the last frame was, in milliseconds
+    double get_last_late_ms() const;
+
+    // ------------------------------------------------------------ //
+
+    // Monotonic time in nanoseconds
+    static int64_t now();
+
+    // ------------------------------------------------------------ //
+
+private:
+    // Sleeping until the time, it may wake up after it
+    static void sleep_until(int64_t time);
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    double m_target;
+    int64_t m_period;
+    int64_t m_deadline;
+    int64_t m_last_late;
+
+    // How long before the deadline the sleep stops, it's
+    // following how late the sleeps of this system wake up
+    int64_t m_spin;
+}; // FrameLimiter
+
+END_NAMESPACE
+
+#endif // FRAME_LIMITER_HPP
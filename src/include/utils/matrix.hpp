@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains a 2D affine matrix (2x3), it's   //
+// used to transform vertices on the CPU instead of      //
+// asking OpenGL to do it for every shape.               //
+///////////////////////////////////////////////////////////
+
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include "utils.hpp"
+#include "vector.hpp"
+
+#include <cmath>
+
+START_NAMESPACE
+
+// | a  c  tx |
+// | b  d  ty |
+// | 0  0  1  |
+struct Matrix
+{
+    float a, b;
+    float c, d;
+    float tx, ty;
+
+    // ------------------------------------------------------------ //
+
+    // Identity matrix
+    constexpr Matrix()
+        : a(1.f), b(0.f), c(0.f), d(1.f), tx(0.f), ty(0.f) {}
+
+    constexpr Matrix(float a_, float b_, float c_, float d_, float tx_, float ty_)
+        : a(a_), b(b_), c(c_), d(d_), tx(tx_), ty(ty_) {}
+
+    // ------------------------------------------------------------ //
+
+    // Same as glTranslatef
+    static Matrix translation(float x, float y) {
+        return Matrix(1.f, 0.f, 0.f, 1.f, x, y);
+    }
+
+    // Same as glRotatef around the Z axis, in degrees
+    static Matrix rotation(float degree)
+    {
+        const float radians = degree * (PI / 180.f);
+        const float cs = std::cos(radians);
+        const float sn = std::sin(radians);
+
+        return Matrix(cs, sn, -sn, cs, 0.f, 0.f);
+    }
+
+    // Same as glScalef
+    static Matrix scaling(float x, float y) {
+        return Matrix(x, 0.f, 0.f, y, 0.f, 0.f);
+    }
+
+    // ------------------------------------------------------------ //
+
+    // Returns true if the matrix does nothing
+    constexpr bool is_identity() const {
+        return a == 1.f && b == 0.f && c == 0.f && d == 1.f && tx == 0.f && ty == 0.f;
+    }
+
+    constexpr bool operator==(const Matrix& rhs) const {
+        return a == rhs.a && b == rhs.b && c == rhs.c && d == rhs.d && tx == rhs.tx && ty == rhs.ty;
+    }
+
+    constexpr bool operator!=(const Matrix& rhs) const {
+        return !(*this == rhs);
+    }
+
+    // ------------------------------------------------------------ //
+
+    // Concatenate two matrices, the right matrix
+    // is applied first (just like OpenGL does)
+    Matrix operator*(const Matrix& rhs) const
+    {
+        return Matrix(
+            a * rhs.a + c * rhs.b,
+            b * rhs.a + d * rhs.b,
+            a * rhs.c + c * rhs.d,
+            b * rhs.c + d * rhs.d,
+            a * rhs.tx + c * rhs.ty + tx,
+            b * rhs.tx + d * rhs.ty + ty);
+    }
+
+    Matrix& operator*=(const Matrix& rhs)
+    {
+        *this = *this * rhs;
+        return *this;
+    }
+
+    // ------------------------------------------------------------ //
+
+    // Transform a single point
+    VectorF apply(float x, float y) const {
+        return VectorF(a * x + c * y + tx, b * x + d * y + ty);
+    }
+
+    template<typename T>
+    VectorF apply(const Vector<T>& vector) const {
+        return apply(static_cast<float>(vector.x), static_cast<float>(vector.y));
+    }
+
+    // The longest column of the 2x2 part, it's how much
+    // the matrix is stretching things on the screen
+    float max_scale() const
+    {
+        const float x = std::sqrt(a * a + b * b);
+        const float y = std::sqrt(c * c + d * d);
+        return x > y ? x : y;
+    }
+}; // Matrix
+
+END_NAMESPACE
+
+#endif // MATRIX_HPP
\ No newline at end of file
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains a fixed size queue for many      //
+// producers and a single consumer, every cell has a     //
+// sequence number so nobody has to lock (D. Vyukov's    //
+// bounded queue).                                       //
+///////////////////////////////////////////////////////////
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+START_NAMESPACE
+
+template<typename T, size_t Capacity>
+class MPSCQueue
+{
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, 
+        "The capacity of the queue must be a power of two");
+
+public:
+    MPSCQueue()
+        : m_head(0), m_tail(0)
+    {
+        for(size_t i = 0; i < Capacity; i++)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Can be called from any thread, returns false if the queue is full
+    bool push(T value)
+    {
+        Cell* cell;
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        while(true)
+        {
+            cell = &m_cells[tail & MASK];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(tail);
+
+            // The cell is free, taking it unless another producer was faster
+            if(difference == 0)
+            {
+                if(m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                    break;
+            }
+            // The consumer didn't take the value of the last round yet
+            else if(difference < 0)
+                return false;
+            else
+                tail = m_tail.load(std::memory_order_relaxed);
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called only from the consumer thread, returns false if the
+    // queue is empty or the next value is still being written
+    bool pop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[head & MASK];
+
+        if(cell.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+
+        // The cell is emptied so it's not keeping anything alive
+        value = std::move(cell.value);
+        cell.value = T();
+
+        // The cell is free for the next round
+        cell.sequence.store(head + Capacity, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // ------------------------------------------------------------ //
+
+    // Only a hint while the other threads are using the queue
+    size_t size() const noexcept
+    {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    // ------------------------------------------------------------ //
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    }; // Cell
+
+    Cell m_cells[Capacity];
+
+    // The producers are fighting on the tail only, and the
+    // consumer is on its own cache line
+    alignas(64) std::atomic<size_t> m_head; // Next one to pop
+    alignas(64) std::atomic<size_t> m_tail; // Next one to push
+}; // MPSCQueue
+
+END_NAMESPACE
+
+#endif // MPSC_QUEUE_HPP
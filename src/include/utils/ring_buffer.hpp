@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains a fixed size ring buffer for a   //
+// single producer and a single consumer, both of them   //
+// can use it at the same time without locking.          //
+///////////////////////////////////////////////////////////
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+START_NAMESPACE
+
+template<typename T, size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, 
+        "The capacity of the ring buffer must be a power of two");
+
+public:
+    RingBuffer()
+        : m_head(0), m_tail(0) {}
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Called only from the producer thread,
+    // returns false if the buffer is full
+    bool push(const T& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_data[tail & MASK] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called only from the consumer thread,
+    // returns false if the buffer is empty
+    bool pop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if(head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        value = m_data[head & MASK];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ------------------------------------------------------------ //
+
+    // Only a hint while the other thread is using the buffer
+    size_t size() const noexcept {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    // ------------------------------------------------------------ //
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    T m_data[Capacity];
+
+    // The indices are only growing, and they are on different
+    // cache lines so both threads are not fighting on them
+    alignas(64) std::atomic<size_t> m_head; // Next one to pop
+    alignas(64) std::atomic<size_t> m_tail; // Next one to push
+}; // RingBuffer
+
+END_NAMESPACE
+
+#endif // RING_BUFFER_HPP
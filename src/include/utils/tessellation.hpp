@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains precomputed unit circles, so     //
+// circles never have to call cosf / sinf while they are //
+// being drawn, and the amount of segments is chosen by  //
+// the size of the circle on the screen.                 //
+///////////////////////////////////////////////////////////
+
+#ifndef TESSELLATION_HPP
+#define TESSELLATION_HPP
+
+#include "utils.hpp"
+#include "vector.hpp"
+#include "matrix.hpp"
+
+START_NAMESPACE
+
+class Tessellation
+{
+public:
+    // This class does not need to be initialized.
+    // Users need to access it's functions directly
+    // because all of the functions are static
+    Tessellation() = delete;
+
+    // ------------------------------------------------------------ //
+
+    // The smallest and the biggest amount of segments
+    static constexpr int MIN_SEGMENTS = 8;
+    static constexpr int MAX_SEGMENTS = 256;
+
+    // ------------------------------------------------------------ //
+
+    // Returns the amount of segments that a circle with this
+    // radius (in pixels) needs, so the distance between the
+    // segments and the real circle is never bigger than a
+    // quarter of a pixel
+    static int segments(float radius);
+
+    // Same as above, the biggest scale of the
+    // circle is taken into account
+    static int segments(float radius, const VectorF& scale);
+
+    // Same as above, the scale comes from the final matrix
+    // so the transform stack is taken into account too
+    static int segments(float radius, const Matrix& matrix);
+
+    // ------------------------------------------------------------ //
+
+    // Returns segments + 1 points of a unit circle, the last
+    // point is the same as the first one, so the circle is closed.
+    // The amount of segments must come from segments()
+    static const VectorF* unit_circle(int segments);
+}; // Tessellation
+
+END_NAMESPACE
+
+#endif // TESSELLATION_HPP
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains a fixed amount of worker threads //
+// that are running tasks from a single queue.           //
+///////////////////////////////////////////////////////////
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "utils.hpp"
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+START_NAMESPACE
+
+class ThreadPool
+{
+public:
+    // Starting the workers, at least one worker is started
+    explicit ThreadPool(size_t workers);
+
+    // Every task that was already submitted is finished
+    // before the workers are stopped
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Running the task on one of the workers, the future
+    // is holding the result or the exception of the task
+    template<typename F>
+    auto submit(F&& task) -> std::future<decltype(task())>
+    {
+        using Result = decltype(task());
+
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push([packaged]() { (*packaged)(); });
+        }
+        m_condition.notify_one();
+
+        return result;
+    }
+
+    // ------------------------------------------------------------ //
+
+    size_t get_worker_count() const noexcept;
+
+    // The amount of threads the hardware can run at once
+    static size_t hardware_workers() noexcept;
+
+    // ------------------------------------------------------------ //
+
+private:
+    // The loop of every worker
+    void work();
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+}; // ThreadPool
+
+END_NAMESPACE
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////
+// Copyright 2020, Eviatar Mor, All rights reserved.     //
+// https://therealcain.github.io/website/                //
+///////////////////////////////////////////////////////////
+// This header contains the window scheduler, it's       //
+// running the frames of many windows on a fixed amount  //
+// of worker threads instead of a thread for every one.  //
+///////////////////////////////////////////////////////////
+
+#ifndef WINDOW_SCHEDULER_HPP
+#define WINDOW_SCHEDULER_HPP
+
+#include "utils/utils.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/aligned.hpp"
+
+#ifdef _WIN32
+#include "windows/renderer.hpp"
+#elif __linux__
+#include "linux/renderer.hpp"
+#endif
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <exception>
+#include <cstdint>
+
+START_NAMESPACE
+
+class WindowScheduler
+{
+public:
+    // The windows are created and updated by the workers, the
+    // thread that calls run is one of them. On Windows the messages
+    // of a window belong to the thread that created it, so there
+    // is always a single worker
+    explicit WindowScheduler(size_t workers);
+
+    WindowScheduler(const WindowScheduler&) = delete;
+    WindowScheduler& operator=(const WindowScheduler&) = delete;
+
+    // ------------------------------------------------------------ //
+
+    // Adding windows of this type, they are created by run
+    template<typename T>
+    void add(size_t count = 1)
+    {
+        static_assert(std::is_base_of<Renderer, T>::value, "Only base of Renderer can be scheduled");
+
+        // The input queue of a window is aligned to a cache line
+        for(size_t i = 0; i < count; i++)
+        {
+            add_window([]() {
+                return Window(aligned_new<T>(), [](Renderer* renderer) {
+                    aligned_delete(static_cast<T*>(renderer));
+                });
+            });
+        }
+    }
+
+    // Running a frame of the window that is due the earliest until
+    // every window is closed, a window is due once its target
+    // frame rate allows it, or right away without a target.
+    // A window that throws is closed, and the first exception
+    // is thrown again once the other windows are closed too
+    void run();
+
+    // ------------------------------------------------------------ //
+
+    size_t get_worker_count() const;
+
+    // The frames of all of the windows together
+    unsigned long get_frames() const;
+
+    // ------------------------------------------------------------ //
+
+private:
+    using Window = std::unique_ptr<Renderer, void(*)(Renderer*)>;
+
+    // A window and when its next frame is due
+    struct Task
+    {
+        std::function<Window()> create;
+        Window window;
+        int64_t due;
+
+        // Running on a worker, or closed
+        bool busy;
+        bool done;
+    }; // Task
+
+    // ------------------------------------------------------------ //
+
+    void add_window(std::function<Window()> create);
+
+    // The loop of every worker
+    void work();
+
+    // Returns false once the window is closed
+    bool run_frame(Task& task);
+
+// ------------------------------------------------------------ //
+
+// Let the user access all of the members if he wants to
+// in order to gain full access
+#ifdef GFX_ACCESS_EVERYTHING
+public:
+#else
+private:
+#endif
+    std::vector<std::unique_ptr<Task>> m_tasks;
+    size_t m_workers;
+    size_t m_remaining;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<unsigned long> m_frames;
+
+    // The first exception of a window
+    std::exception_ptr m_error;
+}; // WindowScheduler
+
+// ------------------------------------------------------------ //
+
+// Like construct_windows, but the windows are
+// sharing the workers instead of a thread each
+template<typename... Args>
+void schedule_windows(size_t workers = ThreadPool::hardware_workers())
+{
+    WindowScheduler scheduler(workers);
+
+    // Adding every type in order
+    int expand[] = { 0, (scheduler.add<Args>(), 0)... };
+    (void)expand;
+
+    scheduler.run();
+}
+
+END_NAMESPACE
+
+#endif // WINDOW_SCHEDULER_HPP
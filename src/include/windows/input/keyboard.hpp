@@ -16,6 +16,9 @@
 
 START_NAMESPACE
 
+// Forward declaration for the renderer
+class Renderer;
+
 class Keyboard
 {
 public:
@@ -62,6 +65,22 @@ public:
     static bool key_pressed(unsigned int key);
     // Returns true if a key was pressed
     static bool key_pressed(Key key);
+
+    // ------------------------------------------------------------ //
+
+    // These are answered from the keys that the renderer is
+    // fetching once every frame, when is_running is called.
+    // Returns true as long as the key is held
+    static bool key_pressed(Renderer& renderer, Key key);
+    static bool key_pressed(Renderer& renderer, unsigned int key);
+
+    // Returns true only on the frame the key went down
+    static bool key_down(Renderer& renderer, Key key);
+    static bool key_down(Renderer& renderer, unsigned int key);
+
+    // Returns true only on the frame the key went up
+    static bool key_released(Renderer& renderer, Key key);
+    static bool key_released(Renderer& renderer, unsigned int key);
 }; // Keyboard
 
 END_NAMESPACE
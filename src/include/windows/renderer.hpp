@@ -19,9 +19,13 @@
 #include "../utils/geometry.hpp"
 
 #include "../parent_renderer.hpp"
+#include "../share_group.hpp"
 
 #include <windows.h>
 
+#include <vector>
+#include <cstdint>
+
 START_NAMESPACE
 
 class Renderer : public ParentRenderer
@@ -30,6 +34,13 @@ public:
     // Constructors
     explicit Renderer(const Geometry& geometry);
     explicit Renderer(unsigned int width, unsigned int height);
+    Renderer(const Geometry& geometry, Backend backend);
+    Renderer(unsigned int width, unsigned int height, Backend backend);
+
+    // The textures and buffers of the window are shared with every
+    // other window of the group, nullptr is not sharing them
+    Renderer(const Geometry& geometry, Backend backend, ShareGroup* group);
+    Renderer(unsigned int width, unsigned int height, Backend backend, ShareGroup* group);
     ~Renderer();
 
 // ------------------------------------------------------------ //
@@ -49,11 +60,20 @@ public:
 
     bool is_running() override;
 
+// ------------------------------------------------------------ //
+
+    bool set_swap_interval(int interval) override;
+
+// ------------------------------------------------------------ //
+
+    void make_current() override;
+    void release_current() override;
+
 // ------------------------------------------------------------ //
 
 private:
     // Calling all of the creation functions
-    void create();
+    void create(Backend backend);
 
     // Initialize all of the class members
     void init_members();
@@ -64,6 +84,9 @@ private:
     // Creates an OpenGL context
     static void create_opengl_context(HWND hwnd) noexcept;
 
+    // Loading the swap control extension of the context
+    void init_swap_control() noexcept;
+
     // This is going to be unused, it's just telling
     // windows to never stop updating the screen
     static void CALLBACK force_update();
@@ -71,6 +94,12 @@ private:
     // Handle all of the events
     bool handle_events() noexcept;
 
+    // Adding the mouse and keyboard messages into the events queue
+    void handle_input(const MSG& message) noexcept;
+
+    // Copying the frame of the software rasterizer into the window
+    void present_software(HDC hdc) noexcept;
+
 // ------------------------------------------------------------ //
 
 // Let the user access all of the members if he wants to
@@ -92,7 +121,28 @@ private:
     // Class has been created
     bool class_registered;
 
+    // The keys of this frame and the last frame,
+    // exactly like GetKeyboardState returns them
+    BYTE keymap[256];
+    BYTE last_keymap[256];
+
+    // The frame of the software rasterizer as BGRX pixels
+    std::vector<uint32_t> image_pixels;
+
+    // The context that was created with the window,
+    // nullptr for headless windows
+    HGLRC opengl_context;
+
+    // The group the context is shared with, or nullptr
+    ShareGroup* share_group;
+
+    // WGL_EXT_swap_control, nullptr if it's not supported
+    BOOL (WINAPI* swap_interval_ext)(int interval);
+    int  (WINAPI* get_swap_interval_ext)();
+    bool adaptive_swap;
+
     friend class Mouse;
+    friend class Keyboard;
     friend class GLFunctions;
 }; // Renderer
 
@@ -0,0 +1,331 @@
+#include "../include/batch.hpp"
+#include "../include/draws/rectangle.hpp"
+#include "../include/draws/circle.hpp"
+#include "../include/draws/shape.hpp"
+#include "../include/draws/sprite.hpp"
+#include "../include/utils/tessellation.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/GL.h>
+#elif __linux__
+#include <GL/gl.h>
+#endif
+
+START_NAMESPACE
+
+void Batch::add(const Rectangle& rect, const Matrix& matrix) {
+    add_cached(rect, matrix);
+}
+
+void Batch::add(const Circle& circle, const Matrix& matrix) {
+    add_cached(circle, matrix);
+}
+
+void Batch::add(const Shape& shape, const Matrix& matrix) {
+    add_cached(shape, matrix);
+}
+
+void Batch::add(const Sprite& sprite, const Matrix& matrix) {
+    add_cached(sprite, matrix);
+}
+
+template<typename T>
+void Batch::add_cached(const T& shape, const Matrix& matrix)
+{
+    BatchCache& cache = shape.m_cache;
+
+    // Nothing was changed since the last time, the
+    // vertices are copied without touching them
+    if(cache.valid && cache.version == shape.m_version && cache.matrix == matrix)
+    {
+        if(cache.vertices.empty())
+            return;
+
+        begin(cache.primitive, cache.texture);
+        m_vertices.insert(m_vertices.end(), cache.vertices.begin(), cache.vertices.end());
+        m_commands.back().count += cache.vertices.size();
+        return;
+    }
+
+    const size_t first = m_vertices.size();
+    tessellate(shape, matrix);
+
+    cache.vertices.assign(m_vertices.begin() + first, m_vertices.end());
+    if(!cache.vertices.empty())
+    {
+        cache.primitive = m_commands.back().primitive;
+        cache.texture = m_commands.back().texture;
+    }
+
+    cache.version = shape.m_version;
+    cache.matrix = matrix;
+    cache.valid = true;
+}
+
+// ------------------------------------------------------------ //
+
+void Batch::tessellate(const Rectangle& rect, const Matrix& matrix)
+{
+    const VectorF corners[4] = {
+        VectorF(rect.m_pos.x, rect.m_pos.y),
+        VectorF(rect.m_pos.x + rect.m_size.width, rect.m_pos.y),
+        VectorF(rect.m_pos.x + rect.m_size.width, rect.m_pos.y + rect.m_size.height),
+        VectorF(rect.m_pos.x, rect.m_pos.y + rect.m_size.height)
+    };
+
+    if(rect.m_fill)
+    {
+        // A quad is built out of two triangles
+        begin(Primitive::Triangles, 0);
+        push(matrix, corners[0].x, corners[0].y, rect.m_color);
+        push(matrix, corners[1].x, corners[1].y, rect.m_color);
+        push(matrix, corners[2].x, corners[2].y, rect.m_color);
+        push(matrix, corners[0].x, corners[0].y, rect.m_color);
+        push(matrix, corners[2].x, corners[2].y, rect.m_color);
+        push(matrix, corners[3].x, corners[3].y, rect.m_color);
+    }
+    else
+    {
+        begin(Primitive::Lines, 0);
+        for(size_t i = 0; i < 4; i++)
+            push_line(matrix, corners[i], rect.m_color, corners[(i + 1) % 4], rect.m_color);
+    }
+}
+
+void Batch::tessellate(const Circle& circle, const Matrix& matrix)
+{
+    // The amount of segments depends on the size on the screen
+    const int segments = Tessellation::segments(circle.m_radius, matrix);
+    const VectorF* unit = Tessellation::unit_circle(segments);
+
+    if (circle.m_fill)
+    {
+        // The triangle fan is split into separated triangles
+        begin(Primitive::Triangles, 0);
+        for (int i = 0; i < segments; i++)
+        {
+            push(matrix, circle.m_pos.x, circle.m_pos.y, circle.m_color);
+            push(matrix,
+                circle.m_pos.x + circle.m_radius * unit[i].x,
+                circle.m_pos.y + circle.m_radius * unit[i].y,
+                circle.m_color);
+            push(matrix,
+                circle.m_pos.x + circle.m_radius * unit[i + 1].x,
+                circle.m_pos.y + circle.m_radius * unit[i + 1].y,
+                circle.m_color);
+        }
+    }
+    else
+    {
+        begin(Primitive::Lines, 0);
+        for (int i = 0; i < segments; i++)
+        {
+            push(matrix,
+                circle.m_pos.x + circle.m_radius * unit[i].x,
+                circle.m_pos.y + circle.m_radius * unit[i].y,
+                circle.m_color);
+            push(matrix,
+                circle.m_pos.x + circle.m_radius * unit[i + 1].x,
+                circle.m_pos.y + circle.m_radius * unit[i + 1].y,
+                circle.m_color);
+        }
+    }
+}
+
+void Batch::tessellate(const Shape& shape, const Matrix& matrix)
+{
+    const std::vector<Vertex>& vertices = shape.m_vertex;
+    if(vertices.size() < 2)
+        return;
+
+    // Polygons are convex, so they can be
+    // split into a triangle fan
+    if(shape.m_connect && shape.m_fill)
+    {
+        if(vertices.size() < 3)
+            return;
+
+        begin(Primitive::Triangles, 0);
+        for(size_t i = 1; i + 1 < vertices.size(); i++)
+        {
+            push(matrix, vertices[0].position.x, vertices[0].position.y, vertices[0].color);
+            push(matrix, vertices[i].position.x, vertices[i].position.y, vertices[i].color);
+            push(matrix, vertices[i + 1].position.x, vertices[i + 1].position.y, vertices[i + 1].color);
+        }
+        return;
+    }
+
+    // Line loop or line strip
+    begin(Primitive::Lines, 0);
+    for(size_t i = 0; i + 1 < vertices.size(); i++)
+    {
+        push_line(
+            matrix,
+            vertices[i].position, vertices[i].color,
+            vertices[i + 1].position, vertices[i + 1].color);
+    }
+
+    if(shape.m_connect)
+    {
+        push_line(
+            matrix,
+            vertices.back().position, vertices.back().color,
+            vertices.front().position, vertices.front().color);
+    }
+}
+
+void Batch::tessellate(const Sprite& sprite, const Matrix& matrix)
+{
+    const float left   = sprite.m_position.x;
+    const float top    = sprite.m_position.y;
+    const float right  = sprite.m_position.x + sprite.m_geometry.width;
+    const float bottom = sprite.m_position.y + sprite.m_geometry.height;
+
+    const VectorF& uv_min = sprite.m_uv_min;
+    const VectorF& uv_max = sprite.m_uv_max;
+
+    // Every texture is a different state, sprites
+    // of the same atlas page are sharing it
+    begin(Primitive::Triangles, sprite.id);
+    push(matrix, left,  top,    uv_min.x, uv_min.y);
+    push(matrix, right, top,    uv_max.x, uv_min.y);
+    push(matrix, right, bottom, uv_max.x, uv_max.y);
+    push(matrix, left,  top,    uv_min.x, uv_min.y);
+    push(matrix, right, bottom, uv_max.x, uv_max.y);
+    push(matrix, left,  bottom, uv_min.x, uv_max.y);
+}
+
+// ------------------------------------------------------------ //
+
+void Batch::flush()
+{
+    if(m_commands.empty())
+        return;
+
+    // Every vertex has already been transformed
+    // so OpenGL should not transform them again
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    const BatchVertex* data = m_vertices.data();
+    glVertexPointer(2, GL_FLOAT, sizeof(BatchVertex), &data->x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(BatchVertex), &data->u);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(BatchVertex), &data->color);
+
+    for(const auto& command : m_commands)
+    {
+        if(command.texture != 0)
+        {
+            glEnable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, command.texture);
+        }
+
+        glDrawArrays(
+            command.primitive == Primitive::Triangles ? GL_TRIANGLES : GL_LINES,
+            static_cast<GLint>(command.first),
+            static_cast<GLsizei>(command.count));
+
+        if(command.texture != 0)
+        {
+            glDisable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+    }
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    // Same as the immediate mode, the next shapes
+    // should not be affected by the last color
+    glColor4f(1.f, 1.f, 1.f, 1.f);
+
+    glPopMatrix();
+
+    clear();
+}
+
+void Batch::clear() noexcept
+{
+    // The capacity is kept, so the next frame
+    // won't allocate again
+    m_vertices.clear();
+    m_commands.clear();
+}
+
+void Batch::append(const Batch& other)
+{
+    for(const auto& command : other.m_commands)
+    {
+        const auto first = other.m_vertices.begin() + command.first;
+
+        begin(command.primitive, command.texture);
+        m_vertices.insert(m_vertices.end(), first, first + command.count);
+        m_commands.back().count += command.count;
+    }
+}
+
+// ------------------------------------------------------------ //
+
+bool Batch::empty() const noexcept {
+    return m_commands.empty();
+}
+
+size_t Batch::vertex_count() const noexcept {
+    return m_vertices.size();
+}
+
+size_t Batch::command_count() const noexcept {
+    return m_commands.size();
+}
+
+// ------------------------------------------------------------ //
+
+void Batch::begin(Primitive primitive, unsigned int texture)
+{
+    if(!m_commands.empty())
+    {
+        Command& last = m_commands.back();
+        if(last.primitive == primitive && last.texture == texture)
+            return;
+    }
+
+    m_commands.push_back({primitive, texture, m_vertices.size(), 0});
+}
+
+void Batch::push(const Matrix& matrix, float x, float y, const Color& color)
+{
+    const VectorF point = matrix.apply(x, y);
+
+    m_vertices.push_back({
+        point.x, point.y,
+        0.f, 0.f,
+        color
+    });
+    m_commands.back().count++;
+}
+
+void Batch::push(const Matrix& matrix, float x, float y, float u, float v)
+{
+    const VectorF point = matrix.apply(x, y);
+
+    // Textures are drawn with a white color
+    // exactly like the immediate mode
+    m_vertices.push_back({ point.x, point.y, u, v, Color(255, 255, 255) });
+    m_commands.back().count++;
+}
+
+void Batch::push_line(const Matrix& matrix, const VectorF& from, const Color& from_color,
+                      const VectorF& to, const Color& to_color)
+{
+    push(matrix, from.x, from.y, from_color);
+    push(matrix, to.x, to.y, to_color);
+}
+
+END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "../include/draw_list.hpp"
+#include "../include/profiler.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+START_NAMESPACE
+
+DrawList::DrawList()
+    : m_transforms(1) {}
+
+// ------------------------------------------------------------ //
+
+void DrawList::add(const Rectangle& rectangle) {
+    m_batch.add(rectangle, transform(rectangle));
+}
+
+void DrawList::add(const Circle& circle) {
+    m_batch.add(circle, transform(circle));
+}
+
+void DrawList::add(const Shape& shape) {
+    m_batch.add(shape, transform(shape));
+}
+
+void DrawList::add(const Sprite& sprite)
+{
+    // The window may be resolving the sprite for an older
+    // list, so its texture is taken while it's locked
+    std::lock_guard<std::mutex> lock(sprite.m_mutex);
+
+    // Only the thread of the window can upload, so the
+    // sprite is resolved when the list is submitted
+    const bool dirty = !sprite.m_locked &&
+        sprite.m_dirty_min.x < sprite.m_dirty_max.x && sprite.m_dirty_min.y < sprite.m_dirty_max.y;
+
+    if(sprite.m_pending.valid() || dirty)
+        m_uploads.push_back(&sprite);
+
+    if(sprite.id != 0 && sprite.m_pending_path.empty())
+        m_batch.add(sprite, transform(sprite));
+}
+
+// ------------------------------------------------------------ //
+
+void DrawList::push_transform(const Transformation& transformation) {
+    m_transforms.push_back(m_transforms.back() * transformation.get_matrix());
+}
+
+void DrawList::push_transform(const Matrix& matrix) {
+    m_transforms.push_back(m_transforms.back() * matrix);
+}
+
+void DrawList::pop_transform()
+{
+    // The first matrix is the screen itself
+    if(m_transforms.size() <= 1)
+        throw std::logic_error("There is no transform to pop!");
+
+    m_transforms.pop_back();
+}
+
+const Matrix& DrawList::get_transform() const {
+    return m_transforms.back();
+}
+
+// ------------------------------------------------------------ //
+
+void DrawList::clear()
+{
+    m_batch.clear();
+    m_transforms.resize(1);
+    m_uploads.clear();
+}
+
+bool DrawList::empty() const {
+    return m_batch.empty() && m_uploads.empty();
+}
+
+size_t DrawList::vertex_count() const {
+    return m_batch.vertex_count();
+}
+
+// ------------------------------------------------------------ //
+
+Matrix DrawList::transform(const Transformation& transformation) const
+{
+    // Nothing to multiply if there is no parent
+    if(m_transforms.size() == 1)
+        return transformation.get_matrix();
+
+    return m_transforms.back() * transformation.get_matrix();
+}
+
+END_NAMESPACE
@@ -4,10 +4,12 @@ START_NAMESPACE
 
 void Circle::set_position(const VectorI& pos) { 
     m_pos = pos;    
+    touch();
 }
 
 void Circle::set_position(int x, int y) { 
     m_pos = {x, y}; 
+    touch();
 }
 
 VectorI Circle::get_position() const { 
@@ -19,6 +21,7 @@ VectorI Circle::get_position() const {
 // Radius
 void Circle::set_radius(float radius) { 
     m_radius = radius; 
+    touch();
 }
 
 float Circle::get_radius() const { 
@@ -30,6 +33,7 @@ float Circle::get_radius() const {
 // Color
 void Circle::set_color(const Color& color) { 
     m_color = color; 
+    touch();
 }
 
 Color Circle::get_color() const { 
@@ -41,6 +45,7 @@ Color Circle::get_color() const {
 // Fill
 void Circle::set_fill(bool fill) { 
     m_fill = fill; 
+    touch();
 }
 
 bool Circle::get_fill() const { 
@@ -5,10 +5,12 @@ START_NAMESPACE
 // Position
 void Rectangle::set_position(const VectorI& pos) { 
     m_pos = pos;    
+    touch();
 }
 
 void Rectangle::set_position(int x, int y) { 
     m_pos = {x, y}; 
+    touch();
 }
 
 const VectorI& Rectangle::get_position() const { 
@@ -20,10 +22,12 @@ const VectorI& Rectangle::get_position() const {
 // Size
 void Rectangle::set_size(const Geometry& size) { 
     m_size = size;  
+    touch();
 }
 
 void Rectangle::set_size(unsigned int x, unsigned int y) { 
     m_size = {x,y}; 
+    touch();
 }
 
 const Geometry& Rectangle::get_size() const { 
@@ -35,6 +39,7 @@ const Geometry& Rectangle::get_size() const {
 // Color
 void Rectangle::set_color(const Color& color) { 
     m_color = color; 
+    touch();
 }
 
 const Color& Rectangle::get_color() const { 
@@ -46,6 +51,7 @@ const Color& Rectangle::get_color() const {
 // Fill
 void Rectangle::set_fill(bool fill) { 
     m_fill = fill; 
+    touch();
 }
 
 bool Rectangle::get_fill() const { 
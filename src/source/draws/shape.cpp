@@ -6,14 +6,18 @@ void Shape::add_vertex(const std::initializer_list<Vertex>& vertices)
 {
     for(const auto& vertex : vertices)
         m_vertex.push_back(vertex); 
+
+    touch();
 }
 
 void Shape::add_vertex(const Vertex& vertex) {
     m_vertex.push_back(vertex);
+    touch();
 }
 
 void Shape::add_vertex() {
     m_vertex.push_back(gfx::Vertex());
+    touch();
 }
 
 // ------------------------------------------------------------ //
@@ -24,6 +28,7 @@ void Shape::update_vertex(const Vertex& vertex, size_t position)
         throw std::logic_error("Vertex position is incorrect!");
 
     m_vertex[position] = vertex;
+    touch();
 }
 
 // ------------------------------------------------------------ //
@@ -36,6 +41,7 @@ const std::vector<Vertex>& Shape::get_vertices() const {
 
 void Shape::set_fill(bool fill){
     m_fill = fill;
+    touch();
 }
 
 bool Shape::get_fill() const { 
@@ -46,6 +52,7 @@ bool Shape::get_fill() const {
 
 void Shape::set_connection(bool connect) { 
     m_connect = connect; 
+    touch();
 }
 
 bool Shape::get_connection() const { 
@@ -1,4 +1,7 @@
 #include "../../include/draws/sprite.hpp"
+#include "../../include/texture_cache.hpp"
+#include "../../include/software_rasterizer.hpp"
+#include "../../include/profiler.hpp"
 
 #ifdef _WIN32
 #include "../../include/windows/renderer.hpp"
@@ -12,28 +15,100 @@
 #include "../../external_libs/stb_image.h"
 
 #include <memory>
+#include <algorithm>
+#include <stdexcept>
 
 START_NAMESPACE
 
 // Create
-Sprite::Sprite(const std::string& path, const VectorI& position) {
+Sprite::Sprite()
+    : id(0), 
+      m_position(0, 0),
+      m_geometry(0, 0),
+      original_geometry(0, 0),
+      m_texture_offset(0, 0),
+      m_uv_min(0.f, 0.f),
+      m_uv_max(1.f, 1.f),
+      m_owns_texture(false),
+      m_detached(false),
+      m_dirty_min(0, 0),
+      m_dirty_max(0, 0),
+      m_locked(false) {}
+
+Sprite::Sprite(const std::string& path, const VectorI& position)
+    : Sprite() {
     create(path, Geometry(10, 10), position);
 }
 
-Sprite::Sprite(const std::string& path, int x, int y) {
+Sprite::Sprite(const std::string& path, int x, int y)
+    : Sprite() {
     create(path, Geometry(10, 10), VectorI(x, y));
 }
 
-Sprite::Sprite(const std::string& path, const Geometry& geometry, const VectorI& position) {
+Sprite::Sprite(const std::string& path, const Geometry& geometry, const VectorI& position)
+    : Sprite() {
     create(path, geometry, position);
 }
 
-Sprite::Sprite(const std::string& path, unsigned int width, unsigned int height, int x, int y) {
+Sprite::Sprite(const std::string& path, unsigned int width, unsigned int height, int x, int y)
+    : Sprite() {
     create(path, Geometry(width, height), VectorI(x, y));
 }
 
-Sprite::~Sprite() {
-    glDeleteTextures(1, &id);
+Sprite::Sprite(const TextureAtlas::Region& region, const VectorI& position)
+    : Sprite() {
+    create(region, position);
+}
+
+// The other sprite may be resolved by a window on another
+// thread, so it's copied while both of them are locked
+Sprite::Sprite(const Sprite& sprite)
+    : Sprite() {
+    *this = sprite;
+}
+
+Sprite& Sprite::operator=(const Sprite& sprite)
+{
+    if(this == &sprite)
+        return *this;
+
+    std::lock(m_mutex, sprite.m_mutex);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
+    std::lock_guard<std::mutex> other_lock(sprite.m_mutex, std::adopt_lock);
+
+    // Both of the sprites are using the texture now
+    if(sprite.m_owns_texture)
+        TextureCache::retain(sprite.id);
+    if(m_owns_texture)
+        TextureCache::release(id);
+
+    Transformation::operator=(sprite);
+    id = sprite.id;
+    m_position = sprite.m_position;
+    m_geometry = sprite.m_geometry;
+    original_geometry = sprite.original_geometry;
+    m_texture_offset = sprite.m_texture_offset;
+    m_uv_min = sprite.m_uv_min;
+    m_uv_max = sprite.m_uv_max;
+    m_owns_texture = sprite.m_owns_texture;
+    m_detached = false;
+    sprite.m_detached = false;
+    m_pending = sprite.m_pending;
+    m_pending_path = sprite.m_pending_path;
+    m_pixels = sprite.m_pixels;
+    m_dirty_min = sprite.m_dirty_min;
+    m_dirty_max = sprite.m_dirty_max;
+    m_locked = false;
+    touch();
+
+    return *this;
+}
+
+Sprite::~Sprite() 
+{
+    // The texture stays in the cache until it's evicted
+    if(m_owns_texture)
+        TextureCache::release(id);
 }
 
 // ------------------------------------------------------------ //
@@ -53,38 +128,294 @@ void Sprite::create(const std::string& path, const Geometry& geometry, const Vec
 
 void Sprite::create(const std::string& path, unsigned int width, unsigned int height, int x, int y) 
 {
-    unsigned char* data;
-    int nr_channels;
+    GFX_PROFILE_ZONE("load sprite");
+
+    // Every sprite of the same image is sharing a single
+    // texture, it's only decoded the first time
+    const TextureCache::Texture texture = TextureCache::acquire(path);
 
-    int width_ = 0;
-    int height_ = 0;
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-    // Fetching all of the data from the image
-    data = stbi_load(path.c_str(), &width_, &height_, &nr_channels, 0);
+    // The last texture of this sprite is not needed anymore
+    if(m_owns_texture)
+        TextureCache::release(id);
+
+    id = texture.id;
+    m_geometry = {width, height};
+    m_position = {x, y};
+    original_geometry = texture.size;
+    m_pending = ImageLoader::Result();
+    m_pending_path.clear();
+
+    m_texture_offset = {0, 0};
+    m_uv_min = {0.f, 0.f};
+    m_uv_max = {1.f, 1.f};
+    m_owns_texture = true;
+    m_detached = false;
+    reset_pixels();
+    touch();
+}
+
+void Sprite::create(const TextureAtlas::Region& region, const VectorI& position) {
+    create(region, region.size.width, region.size.height, position.x, position.y);
+}
 
-    if (data)
+void Sprite::create(const TextureAtlas::Region& region, unsigned int width, unsigned int height, int x, int y)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_owns_texture)
+        TextureCache::release(id);
+
+    id = region.texture;
+    m_geometry = {width, height};
+    m_position = {x, y};
+    original_geometry = region.size;
+    m_pending = ImageLoader::Result();
+    m_pending_path.clear();
+
+    m_texture_offset = region.position;
+    m_uv_min = region.uv_min;
+    m_uv_max = region.uv_max;
+    m_owns_texture = false;
+    m_detached = false;
+    reset_pixels();
+    touch();
+}
+
+void Sprite::create_async(const std::string& path, const Geometry& geometry, const VectorI& position) {
+    create_async(path, geometry.width, geometry.height, position.x, position.y);
+}
+
+void Sprite::create_async(const std::string& path, unsigned int width, unsigned int height, int x, int y)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_owns_texture)
+        TextureCache::release(id);
+
+    m_geometry = {width, height};
+    m_position = {x, y};
+    m_texture_offset = {0, 0};
+    m_uv_min = {0.f, 0.f};
+    m_uv_max = {1.f, 1.f};
+    m_detached = false;
+    reset_pixels();
+    touch();
+
+    // Nothing to decode if it's already a texture
+    TextureCache::Texture texture;
+    if(TextureCache::try_acquire(path, texture))
     {
-        // Creating a texture based on this data
-        glGenTextures(1, &id);
-        glBindTexture(GL_TEXTURE_2D, id);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D(GL_TEXTURE_2D, 0, 4, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        id = texture.id;
+        original_geometry = texture.size;
+        m_owns_texture = true;
+        m_pending = ImageLoader::Result();
+        m_pending_path.clear();
+        return;
+    }
+
+    id = 0;
+    original_geometry = {0, 0};
+    m_owns_texture = false;
+    m_pending = ImageLoader::load(path);
+    m_pending_path = path;
+}
+
+bool Sprite::is_ready() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return id != 0 && m_pending_path.empty();
+}
+
+bool Sprite::is_loading() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.valid();
+}
+
+bool Sprite::resolve() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(!finish_load())
+        return false;
+
+    upload_pixels();
+    return true;
+}
 
-        // Cleaning data because the data already passed 
-        // to opengl
-        stbi_image_free(data);
+bool Sprite::finish_load() const
+{
+    if(m_pending.valid())
+    {
+        // Never waiting for the workers
+        if(m_pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+
+        const std::shared_ptr<const ImageLoader::Image> image = m_pending.get();
+        m_pending = ImageLoader::Result();
+
+        if(!image->is_valid())
+        {
+            std::cout << "[GFX] Failed to load texture: " << m_pending_path << std::endl;
+            return false;
+        }
+
+        const TextureCache::Texture texture = TextureCache::acquire(
+            m_pending_path, image->pixels.data(), image->size.width, image->size.height);
+
+        id = texture.id;
+        original_geometry = texture.size;
+        m_owns_texture = true;
+        m_detached = false;
+        m_pending_path.clear();
+    }
+    else if(!m_pending_path.empty())
+        return false;
+
+    return true;
+}
+
+void Sprite::upload_pixels() const
+{
+    // Uploading every pixel that was changed since the last
+    // draw in a single call, unless the user is still writing
+    if(m_locked || m_dirty_min.x >= m_dirty_max.x || m_dirty_min.y >= m_dirty_max.y)
+        return;
+
+    if(SoftwareRasterizer::current())
+    {
+        SoftwareRasterizer::update_texture(
+            id, 
+            m_texture_offset.x + m_dirty_min.x, m_texture_offset.y + m_dirty_min.y,
+            m_dirty_max.x - m_dirty_min.x, m_dirty_max.y - m_dirty_min.y,
+            &m_pixels[m_dirty_min.y * original_geometry.width + m_dirty_min.x], 
+            original_geometry.width);
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, original_geometry.width);
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0, 
+            m_texture_offset.x + m_dirty_min.x, m_texture_offset.y + m_dirty_min.y,
+            m_dirty_max.x - m_dirty_min.x, m_dirty_max.y - m_dirty_min.y,
+            GL_RGBA, GL_UNSIGNED_BYTE, 
+            &m_pixels[m_dirty_min.y * original_geometry.width + m_dirty_min.x]);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
 
+    m_dirty_min = {0, 0};
+    m_dirty_max = {0, 0};
+}
 
-        m_geometry = {width, height};
-        m_position = {x, y};
-        original_geometry = {static_cast<unsigned int>(width_), static_cast<unsigned int>(height_)};
+bool Sprite::read_pixels()
+{
+    // Only finishing the load, the changes are uploaded when
+    // it's drawn so the dirty rectangle keeps growing until then
+    if(!finish_load() || id == 0)
+        return false;
+
+    const size_t size = static_cast<size_t>(original_geometry.width) * original_geometry.height;
+    if(m_pixels.size() == size)
+        return true;
+
+    // The whole texture is read, an atlas page
+    // is bigger than the image of the sprite
+    GLint width = 0, height = 0;
+    std::vector<Color> texture;
+
+    SoftwareRasterizer::Texture software;
+    if(SoftwareRasterizer::current() && SoftwareRasterizer::read_texture(id, software))
+    {
+        width = software.size.width;
+        height = software.size.height;
+        texture.swap(software.pixels);
     }
     else
-        throw std::logic_error("Failed to load texture!");
+    {
+        glBindTexture(GL_TEXTURE_2D, id);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+
+        texture.resize(static_cast<size_t>(width) * height);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    m_pixels.resize(size);
+    for(unsigned int y = 0; y < original_geometry.height; y++)
+    {
+        if(m_texture_offset.y + y >= static_cast<unsigned int>(height))
+            break;
+
+        const Color* row = &texture[(m_texture_offset.y + y) * width + m_texture_offset.x];
+        std::copy(row, row + original_geometry.width, &m_pixels[y * original_geometry.width]);
+    }
+
+    return true;
+}
+
+bool Sprite::detach()
+{
+    // Already checked since the texture was last replaced
+    if(m_detached)
+        return true;
+
+    if(!read_pixels())
+        return false;
+
+    if(m_owns_texture && TextureCache::is_unique(id))
+    {
+        m_detached = true;
+        return true;
+    }
+
+    // The copy already has every change, so it's uploaded as it
+    // is and the texture that is shared is never written into
+    const TextureCache::Texture texture = TextureCache::create(
+        reinterpret_cast<const unsigned char*>(m_pixels.data()), original_geometry.width, original_geometry.height);
+
+    if(m_owns_texture)
+        TextureCache::release(id);
+
+    id = texture.id;
+    m_owns_texture = true;
+    m_texture_offset = {0, 0};
+    m_uv_min = {0.f, 0.f};
+    m_uv_max = {1.f, 1.f};
+    m_dirty_min = {0, 0};
+    m_dirty_max = {0, 0};
+    m_detached = true;
+    touch();
+
+    return true;
+}
+
+void Sprite::mark_dirty(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+    if(m_dirty_min.x >= m_dirty_max.x || m_dirty_min.y >= m_dirty_max.y)
+    {
+        m_dirty_min = {x, y};
+        m_dirty_max = {x + width, y + height};
+        return;
+    }
+
+    m_dirty_min = { std::min(m_dirty_min.x, x), std::min(m_dirty_min.y, y) };
+    m_dirty_max = { std::max(m_dirty_max.x, x + width), std::max(m_dirty_max.y, y + height) };
+}
+
+void Sprite::reset_pixels()
+{
+    m_pixels.clear();
+    m_pixels.shrink_to_fit();
+    m_dirty_min = {0, 0};
+    m_dirty_max = {0, 0};
+    m_locked = false;
 }
 
 // ------------------------------------------------------------ //
@@ -92,10 +423,12 @@ void Sprite::create(const std::string& path, unsigned int width, unsigned int he
 // Size
 void Sprite::set_size(const Geometry& size) {
     m_geometry = size;
+    touch();
 }
 
 void Sprite::set_size(unsigned int x, unsigned int y) {
     m_geometry = {x, y};
+    touch();
 }
 
 const Geometry& Sprite::get_size() const {
@@ -111,10 +444,12 @@ const Geometry& Sprite::get_texture_size() const {
 // Position
 void Sprite::set_position(const VectorI& pos) {
     m_position = pos;
+    touch();
 }
 
 void Sprite::set_position(int x, int y) {
     m_position = {x, y};
+    touch();
 }
 
 const VectorI& Sprite::get_position() const {
@@ -137,16 +472,64 @@ void Sprite::set_pixel(unsigned int x, unsigned int y, Color& color) {
 
 void Sprite::set_pixel(unsigned int x, unsigned int y, Color&& color) 
 {
-    GLfloat colors[4] = { 
-        rgba_to_gl(color.r), 
-        rgba_to_gl(color.g), 
-        rgba_to_gl(color.b), 
-        rgba_to_gl(color.a) 
-    };
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(x >= original_geometry.width || y >= original_geometry.height || !detach())
+        return;
 
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 1, 1, GL_RGBA, GL_FLOAT, &colors);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    m_pixels[y * original_geometry.width + x] = color;
+    mark_dirty(x, y, 1, 1);
+}
+
+void Sprite::set_pixels(const VectorUI& pos, const Geometry& size, const Color* colors) {
+    set_pixels(pos.x, pos.y, size.width, size.height, colors);
+}
+
+void Sprite::set_pixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height, const Color* colors)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(x >= original_geometry.width || y >= original_geometry.height || !detach())
+        return;
+
+    // Anything outside of the texture is ignored
+    const unsigned int copied_width  = std::min(width,  original_geometry.width  - x);
+    const unsigned int copied_height = std::min(height, original_geometry.height - y);
+
+    for(unsigned int row = 0; row < copied_height; row++)
+    {
+        const Color* from = colors + static_cast<size_t>(row) * width;
+        std::copy(from, from + copied_width, &m_pixels[(y + row) * original_geometry.width + x]);
+    }
+
+    mark_dirty(x, y, copied_width, copied_height);
+}
+
+Color* Sprite::lock_pixels()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_locked)
+        throw std::logic_error("The pixels are already locked!");
+
+    // Unlocking is uploading the whole copy, so
+    // it cannot be a texture of other sprites
+    if(!detach())
+        throw std::logic_error("The sprite has no texture yet!");
+
+    m_locked = true;
+    return m_pixels.data();
+}
+
+void Sprite::unlock_pixels()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(!m_locked)
+        throw std::logic_error("The pixels are not locked!");
+
+    m_locked = false;
+    mark_dirty(0, 0, original_geometry.width, original_geometry.height);
 }
 
 Color Sprite::get_pixel(const Renderer& renderer, const VectorUI& pos) {
@@ -154,15 +537,20 @@ Color Sprite::get_pixel(const Renderer& renderer, const VectorUI& pos) {
 }
 
 Color Sprite::get_pixel(const Renderer& renderer, unsigned int x, unsigned int y) {
-    GLfloat colors[4];
+    // The last frame that was drawn by the software rasterizer
+    if(renderer.get_rasterizer())
+        return renderer.get_rasterizer()->get_pixel(x, y);
+
+    Color color;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
     glReadPixels(
         x, renderer.get_geometry().height - y - 1, 
         1, 1,
         GL_RGBA,
-        GL_FLOAT,
-        &colors);
+        GL_UNSIGNED_BYTE,
+        &color);
     
-    return {colors[0], colors[1], colors[2], colors[3]};
+    return color;
 }
 
 END_NAMESPACE
\ No newline at end of file
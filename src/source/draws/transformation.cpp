@@ -5,16 +5,24 @@ START_NAMESPACE
 Transformation::Transformation()
     : m_translate(0, 0),
       m_scale(1.f, 1.f),
-      m_degree(0) {}
+      m_degree(0),
+      m_matrix_dirty(false),
+      m_version(0) {}
 
 // ------------------------------------------------------------ //
 
-void Transformation::set_translate(const VectorI& translate) {
+void Transformation::set_translate(const VectorI& translate) 
+{
     m_translate = translate;
+    m_matrix_dirty = true;
+    touch();
 }
 
-void Transformation::set_translate(int x, int y) {
+void Transformation::set_translate(int x, int y) 
+{
     m_translate = {x, y};
+    m_matrix_dirty = true;
+    touch();
 }
 
 const VectorI& Transformation::get_translate() const {
@@ -23,12 +31,18 @@ const VectorI& Transformation::get_translate() const {
 
 // ------------------------------------------------------------ //
 
-void Transformation::set_scale(const VectorF& scale) {
+void Transformation::set_scale(const VectorF& scale) 
+{
     m_scale = scale;
+    m_matrix_dirty = true;
+    touch();
 }
 
-void Transformation::set_scale(float x, float y) {
+void Transformation::set_scale(float x, float y) 
+{
     m_scale = {x, y};
+    m_matrix_dirty = true;
+    touch();
 }
 
 const VectorF& Transformation::get_scale() const {
@@ -37,12 +51,41 @@ const VectorF& Transformation::get_scale() const {
 
 // ------------------------------------------------------------ //
 
-void Transformation::set_rotation(float degree) {
+void Transformation::set_rotation(float degree) 
+{
     m_degree = degree;
+    m_matrix_dirty = true;
+    touch();
 }
 
 float Transformation::get_rotation() const {
     return m_degree;
 }
 
+// ------------------------------------------------------------ //
+
+const Matrix& Transformation::get_matrix() const
+{
+    if(m_matrix_dirty)
+    {
+        // Same order as glTranslatef * glRotatef * glScalef
+        m_matrix = Matrix::translation(m_translate.x, m_translate.y) *
+                   Matrix::rotation(m_degree) *
+                   Matrix::scaling(m_scale.x, m_scale.y);
+        m_matrix_dirty = false;
+    }
+
+    return m_matrix;
+}
+
+// ------------------------------------------------------------ //
+
+unsigned long Transformation::get_version() const {
+    return m_version;
+}
+
+void Transformation::touch() noexcept {
+    m_version++;
+}
+
 END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "../include/frame_pipeline.hpp"
+#include "../include/profiler.hpp"
+
+#include <stdexcept>
+
+START_NAMESPACE
+
+FramePipeline::FramePipeline(size_t buffers)
+    : m_first(0), m_ready(0), m_acquired(false), m_frame_number(0), m_running(false)
+{
+    if(buffers < 2 || buffers > MAX_BUFFERS)
+        throw std::logic_error("A frame pipeline has 2 or 3 buffers!");
+
+    m_buffers = buffers;
+}
+
+FramePipeline::~FramePipeline() {
+    stop();
+}
+
+// ------------------------------------------------------------ //
+
+void FramePipeline::start(std::function<void(DrawList&)> simulate)
+{
+    if(m_thread.joinable())
+        throw std::logic_error("The frame pipeline was already started!");
+
+    m_simulate = std::move(simulate);
+    m_first = 0;
+    m_ready = 0;
+    m_acquired = false;
+    m_error = nullptr;
+    m_running = true;
+
+    m_thread = std::thread(&FramePipeline::simulate, this);
+}
+
+void FramePipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    if(m_thread.joinable())
+        m_thread.join();
+}
+
+// ------------------------------------------------------------ //
+
+const DrawList* FramePipeline::acquire()
+{
+    GFX_PROFILE_ZONE("acquire frame");
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(m_acquired)
+        throw std::logic_error("The last frame was not released!");
+
+    m_condition.wait(lock, [this]() { return m_ready > 0 || !m_running || m_error; });
+
+    if(m_error)
+        std::rethrow_exception(m_error);
+
+    if(!m_running)
+        return nullptr;
+
+    m_acquired = true;
+    m_frame_number++;
+    return &m_lists[m_first];
+}
+
+void FramePipeline::release()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_acquired)
+            return;
+
+        m_acquired = false;
+        m_first = (m_first + 1) % m_buffers;
+        m_ready--;
+    }
+    m_condition.notify_all();
+}
+
+// ------------------------------------------------------------ //
+
+unsigned long FramePipeline::get_frame_number() const {
+    return m_frame_number > 0 ? m_frame_number - 1 : 0;
+}
+
+// ------------------------------------------------------------ //
+
+void FramePipeline::simulate()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true)
+    {
+        // Every list is either waiting to be drawn or being drawn
+        m_condition.wait(lock, [this]() { return m_ready < m_buffers || !m_running; });
+        if(!m_running)
+            return;
+
+        // The list after the ones that are ready, the acquired
+        // list is the first one of them so it's never simulated into
+        DrawList& list = m_lists[(m_first + m_ready) % m_buffers];
+        lock.unlock();
+
+        try
+        {
+            GFX_PROFILE_ZONE("simulate frame");
+            list.clear();
+            m_simulate(list);
+        }
+        catch(...)
+        {
+            lock.lock();
+            m_error = std::current_exception();
+            m_condition.notify_all();
+            return;
+        }
+
+        lock.lock();
+        m_ready++;
+        m_condition.notify_all();
+    }
+}
+
+END_NAMESPACE
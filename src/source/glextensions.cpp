@@ -0,0 +1,156 @@
+#include "../include/glextensions.hpp"
+
+#ifdef __linux__
+#include <GL/glx.h>
+#endif
+
+#include <cstdio>
+
+START_NAMESPACE
+
+// Casting the loaded pointer into the function type
+#define GFX_LOAD(type, name) reinterpret_cast<type>(load(name))
+
+GLExtensions::GLExtensions()
+    : m_major(1), m_minor(0)
+{
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if(version)
+        std::sscanf(version, "%d.%d", &m_major, &m_minor);
+
+    const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if(extensions)
+        m_extensions = std::string(" ") + extensions + " ";
+
+    gen_buffers     = GFX_LOAD(PFNGLGENBUFFERSPROC,    "glGenBuffers");
+    delete_buffers  = GFX_LOAD(PFNGLDELETEBUFFERSPROC, "glDeleteBuffers");
+    bind_buffer     = GFX_LOAD(PFNGLBINDBUFFERPROC,    "glBindBuffer");
+    buffer_data     = GFX_LOAD(PFNGLBUFFERDATAPROC,    "glBufferData");
+    buffer_sub_data = GFX_LOAD(PFNGLBUFFERSUBDATAPROC, "glBufferSubData");
+    map_buffer      = GFX_LOAD(PFNGLMAPBUFFERPROC,     "glMapBuffer");
+    unmap_buffer    = GFX_LOAD(PFNGLUNMAPBUFFERPROC,   "glUnmapBuffer");
+
+    create_shader        = GFX_LOAD(PFNGLCREATESHADERPROC,       "glCreateShader");
+    delete_shader        = GFX_LOAD(PFNGLDELETESHADERPROC,       "glDeleteShader");
+    shader_source        = GFX_LOAD(PFNGLSHADERSOURCEPROC,       "glShaderSource");
+    compile_shader       = GFX_LOAD(PFNGLCOMPILESHADERPROC,      "glCompileShader");
+    get_shader_iv        = GFX_LOAD(PFNGLGETSHADERIVPROC,        "glGetShaderiv");
+    create_program       = GFX_LOAD(PFNGLCREATEPROGRAMPROC,      "glCreateProgram");
+    delete_program       = GFX_LOAD(PFNGLDELETEPROGRAMPROC,      "glDeleteProgram");
+    attach_shader        = GFX_LOAD(PFNGLATTACHSHADERPROC,       "glAttachShader");
+    bind_attrib_location = GFX_LOAD(PFNGLBINDATTRIBLOCATIONPROC, "glBindAttribLocation");
+    link_program         = GFX_LOAD(PFNGLLINKPROGRAMPROC,        "glLinkProgram");
+    get_program_iv       = GFX_LOAD(PFNGLGETPROGRAMIVPROC,       "glGetProgramiv");
+    use_program          = GFX_LOAD(PFNGLUSEPROGRAMPROC,         "glUseProgram");
+    enable_vertex_attrib_array  = GFX_LOAD(PFNGLENABLEVERTEXATTRIBARRAYPROC,  "glEnableVertexAttribArray");
+    disable_vertex_attrib_array = GFX_LOAD(PFNGLDISABLEVERTEXATTRIBARRAYPROC, "glDisableVertexAttribArray");
+    vertex_attrib_pointer       = GFX_LOAD(PFNGLVERTEXATTRIBPOINTERPROC,      "glVertexAttribPointer");
+
+    // Core since OpenGL 3.3, otherwise it's coming from the ARB extensions
+    if(has_version(3, 3))
+    {
+        draw_arrays_instanced = GFX_LOAD(PFNGLDRAWARRAYSINSTANCEDARBPROC, "glDrawArraysInstanced");
+        vertex_attrib_divisor = GFX_LOAD(PFNGLVERTEXATTRIBDIVISORARBPROC, "glVertexAttribDivisor");
+    }
+    else if(has_extension("GL_ARB_draw_instanced") && has_extension("GL_ARB_instanced_arrays"))
+    {
+        draw_arrays_instanced = GFX_LOAD(PFNGLDRAWARRAYSINSTANCEDARBPROC, "glDrawArraysInstancedARB");
+        vertex_attrib_divisor = GFX_LOAD(PFNGLVERTEXATTRIBDIVISORARBPROC, "glVertexAttribDivisorARB");
+    }
+    else
+    {
+        draw_arrays_instanced = nullptr;
+        vertex_attrib_divisor = nullptr;
+    }
+
+    // Core since OpenGL 3.2, the extension is using the same names
+    if(has_version(3, 2) || has_extension("GL_ARB_sync"))
+    {
+        fence_sync       = GFX_LOAD(PFNGLFENCESYNCPROC,      "glFenceSync");
+        client_wait_sync = GFX_LOAD(PFNGLCLIENTWAITSYNCPROC, "glClientWaitSync");
+        delete_sync      = GFX_LOAD(PFNGLDELETESYNCPROC,     "glDeleteSync");
+    }
+    else
+    {
+        fence_sync       = nullptr;
+        client_wait_sync = nullptr;
+        delete_sync      = nullptr;
+    }
+
+    // Core since OpenGL 3.3, the extension is using the same names
+    if(has_version(3, 3) || has_extension("GL_ARB_timer_query"))
+    {
+        gen_queries            = GFX_LOAD(PFNGLGENQUERIESPROC,          "glGenQueries");
+        delete_queries         = GFX_LOAD(PFNGLDELETEQUERIESPROC,       "glDeleteQueries");
+        get_query_iv           = GFX_LOAD(PFNGLGETQUERYIVPROC,          "glGetQueryiv");
+        query_counter          = GFX_LOAD(PFNGLQUERYCOUNTERPROC,        "glQueryCounter");
+        get_query_object_iv    = GFX_LOAD(PFNGLGETQUERYOBJECTIVPROC,    "glGetQueryObjectiv");
+        get_query_object_ui64v = GFX_LOAD(PFNGLGETQUERYOBJECTUI64VPROC, "glGetQueryObjectui64v");
+    }
+    else
+    {
+        gen_queries            = nullptr;
+        delete_queries         = nullptr;
+        get_query_iv           = nullptr;
+        query_counter          = nullptr;
+        get_query_object_iv    = nullptr;
+        get_query_object_ui64v = nullptr;
+    }
+}
+
+#undef GFX_LOAD
+
+// ------------------------------------------------------------ //
+
+bool GLExtensions::has_extension(const std::string& name) const {
+    return m_extensions.find(" " + name + " ") != std::string::npos;
+}
+
+bool GLExtensions::has_version(int major, int minor) const {
+    return m_major > major || (m_major == major && m_minor >= minor);
+}
+
+// ------------------------------------------------------------ //
+
+bool GLExtensions::buffers() const
+{
+    return has_version(1, 5) &&
+        gen_buffers && delete_buffers && bind_buffer &&
+        buffer_data && buffer_sub_data && map_buffer && unmap_buffer;
+}
+
+bool GLExtensions::shaders() const
+{
+    return has_version(2, 0) &&
+        create_shader && delete_shader && shader_source && compile_shader &&
+        get_shader_iv && create_program && delete_program && attach_shader &&
+        bind_attrib_location && link_program && get_program_iv && use_program &&
+        enable_vertex_attrib_array && disable_vertex_attrib_array && vertex_attrib_pointer;
+}
+
+bool GLExtensions::instancing() const {
+    return buffers() && shaders() && draw_arrays_instanced && vertex_attrib_divisor;
+}
+
+bool GLExtensions::fences() const {
+    return fence_sync && client_wait_sync && delete_sync;
+}
+
+bool GLExtensions::timer_queries() const
+{
+    return gen_queries && delete_queries && get_query_iv && query_counter &&
+        get_query_object_iv && get_query_object_ui64v;
+}
+
+// ------------------------------------------------------------ //
+
+void* GLExtensions::load(const char* name)
+{
+#ifdef _WIN32
+    return reinterpret_cast<void*>(wglGetProcAddress(name));
+#elif __linux__
+    return reinterpret_cast<void*>(glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name)));
+#endif
+}
+
+END_NAMESPACE
\ No newline at end of file
@@ -1,4 +1,8 @@
 #include "../include/glfunctions.hpp"
+#include "../include/utils/tessellation.hpp"
+#include "../include/profiler.hpp"
+
+#include <stdexcept>
 
 #ifdef _WIN32
 #include <gl/GL.h> 
@@ -12,35 +16,65 @@
 START_NAMESPACE
 
 GLFunctions::GLFunctions(Renderer& renderer)
-    : m_renderer(renderer) {}
+    : m_renderer(renderer), m_mode(Mode::Immediate), m_transforms(1) {}
+
+GLFunctions::GLFunctions(Renderer& renderer, Mode mode)
+    : m_renderer(renderer), m_mode(mode), m_transforms(1) {}
+
+GLFunctions::~GLFunctions() = default;
 
 // ------------------------------------------------------------ //
 
 void GLFunctions::clear() noexcept 
 {
-    // Clearing the buffers
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    // This function expect a value between 0 to 1
-    glClearColor(0.f, 0.f, 0.f, 1.f);
+    // Anything that was batched is going to be
+    // cleared anyway, so there is no need to draw it
+    clear(Color(0, 0, 0));
 }
 
 void GLFunctions::clear(const Color& color) noexcept
 {
-    // Clearing the buffers
-    glClear(GL_COLOR_BUFFER_BIT);
-    
+    // Anything that was batched is going to be
+    // cleared anyway, so there is no need to draw it
+    m_renderer.m_batch.clear();
+
+    if(m_renderer.m_software)
+    {
+        m_renderer.m_software->clear(color);
+        return;
+    }
+
+    // This function expect a value between 0 to 1, and
+    // it has to be set before the buffers are cleared
     glClearColor(
         rgba_to_gl(color.r), 
         rgba_to_gl(color.g), 
         rgba_to_gl(color.b), 
         rgba_to_gl(color.a));
+
+    // Clearing the buffers
+    glClear(GL_COLOR_BUFFER_BIT);
 }
 
 // ------------------------------------------------------------ //
 
 void GLFunctions::start() noexcept
 {    
+    // The batched shapes were drawn with the last projection
+    m_renderer.flush_batch();
+
+    // The frame of the GPU starts here and ends on swap_buffers
+    if(m_renderer.m_gpu_timer)
+        m_renderer.m_gpu_timer->begin_frame();
+
+    // Dropping every transform that wasn't popped
+    m_transforms.resize(1);
+
+    // The software rasterizer is always drawing
+    // in the coordinates of the window
+    if(m_renderer.m_software)
+        return;
+
     // Changing the viewport to screen size
     glViewport(0, 0, m_renderer.m_geometry.width, m_renderer.m_geometry.height);
 
@@ -49,8 +83,8 @@ void GLFunctions::start() noexcept
     glLoadIdentity();
     glOrtho(0, m_renderer.m_geometry.width, m_renderer.m_geometry.height, 0, -1, 1);
 
-    // The matrix of all of the objects are going to be 
-    // treated as the model view
+    // The shapes are transformed on the CPU, so the
+    // model view is never changed after this
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 }
@@ -59,23 +93,23 @@ void GLFunctions::start() noexcept
 
 void GLFunctions::draw(const Rectangle& rect) noexcept
 {
-    glTranslatef(rect.m_translate.x, rect.m_translate.y, 0.f);
-    glRotatef(rect.m_degree, 0.f, 0.f, 1.f);
-    glScalef(rect.m_scale.x, rect.m_scale.y, 0.f);
+    GFX_PROFILE_ZONE("draw rectangle");
+    const Matrix matrix = transform(rect);
 
-    glColor4f(
-        rgba_to_gl(rect.m_color.r),
-        rgba_to_gl(rect.m_color.g),
-        rgba_to_gl(rect.m_color.b),
-        rgba_to_gl(rect.m_color.a)
-    );
+    if(batching())
+    {
+        m_renderer.m_batch.add(rect, matrix);
+        return;
+    }
+
+    glColor4ub(rect.m_color.r, rect.m_color.g, rect.m_color.b, rect.m_color.a);
 
     // Draw the rectangle
     glBegin(rect.m_fill ? GL_QUADS : GL_LINE_LOOP);
-    glVertex2f(rect.m_pos.x, rect.m_pos.y);
-    glVertex2f(rect.m_pos.x + rect.m_size.width, rect.m_pos.y);
-    glVertex2f(rect.m_pos.x + rect.m_size.width, rect.m_pos.y + rect.m_size.height);
-    glVertex2f(rect.m_pos.x, rect.m_pos.y + rect.m_size.height);
+    vertex(matrix, rect.m_pos.x, rect.m_pos.y);
+    vertex(matrix, rect.m_pos.x + rect.m_size.width, rect.m_pos.y);
+    vertex(matrix, rect.m_pos.x + rect.m_size.width, rect.m_pos.y + rect.m_size.height);
+    vertex(matrix, rect.m_pos.x, rect.m_pos.y + rect.m_size.height);
     glEnd();
 
     // Reset all of the colors to allow
@@ -86,46 +120,41 @@ void GLFunctions::draw(const Rectangle& rect) noexcept
 
 void GLFunctions::draw(const Circle& circle)
 {
-    glTranslatef(circle.m_translate.x, circle.m_translate.y, 0.f);
-    glRotatef(circle.m_degree, 0.f, 0.f, 1.f);
-    glScalef(circle.m_scale.x, circle.m_scale.y, 0.f);
+    GFX_PROFILE_ZONE("draw circle");
+    const Matrix matrix = transform(circle);
+
+    if(batching())
+    {
+        m_renderer.m_batch.add(circle, matrix);
+        return;
+    }
 
-    glColor4f(
-        rgba_to_gl(circle.m_color.r),
-        rgba_to_gl(circle.m_color.g),
-        rgba_to_gl(circle.m_color.b),
-        rgba_to_gl(circle.m_color.a)
-    );
+    glColor4ub(circle.m_color.r, circle.m_color.g, circle.m_color.b, circle.m_color.a);
+
+    // The amount of segments depends on the size on the screen
+    const int segments = Tessellation::segments(circle.m_radius, matrix);
+    const VectorF* unit = Tessellation::unit_circle(segments);
 
     if (circle.m_fill)
     {
         glBegin(GL_TRIANGLE_FAN);
-        glVertex2i(circle.m_pos.x, circle.m_pos.y);
-        for (int i = 0; i <= 20; i++)
+        vertex(matrix, circle.m_pos.x, circle.m_pos.y);
+        for (int i = 0; i <= segments; i++)
         {
-            VectorI temp;
-            temp.x = circle.m_pos.x + (circle.m_radius * cosf(i * PI2 / 20.0));
-            temp.y = circle.m_pos.y + (circle.m_radius * sinf(i * PI2 / 20.0));
-
-            glVertex2i(temp.x, temp.y);
+            vertex(matrix,
+                circle.m_pos.x + circle.m_radius * unit[i].x,
+                circle.m_pos.y + circle.m_radius * unit[i].y);
         }
         glEnd();
     }
     else
     {
-        // Can be any other value
-        constexpr int segments = 100;
-
         glBegin(GL_LINE_LOOP);
         for (int i = 0; i < segments; i++)
         {
-            float theta = PI2 * i / segments;
-
-            VectorI temp;
-            temp.x = static_cast<int>(circle.m_radius * cosf(theta));
-            temp.y = static_cast<int>(circle.m_radius * sinf(theta));
-
-            glVertex2i(circle.m_pos.x + temp.x, circle.m_pos.y + temp.y);
+            vertex(matrix,
+                circle.m_pos.x + circle.m_radius * unit[i].x,
+                circle.m_pos.y + circle.m_radius * unit[i].y);
         }
         glEnd();
     }
@@ -135,9 +164,14 @@ void GLFunctions::draw(const Circle& circle)
 
 void GLFunctions::draw(const Shape& shape) noexcept
 {
-    glTranslatef(shape.m_translate.x, shape.m_translate.y, 0.f);
-    glRotatef(shape.m_degree, 0.f, 0.f, 1.f);
-    glScalef(shape.m_scale.x, shape.m_scale.y, 0.f);
+    GFX_PROFILE_ZONE("draw shape");
+    const Matrix matrix = transform(shape);
+
+    if(batching())
+    {
+        m_renderer.m_batch.add(shape, matrix);
+        return;
+    }
 
     if(shape.m_connect)
     {
@@ -149,15 +183,12 @@ void GLFunctions::draw(const Shape& shape) noexcept
     else
         glBegin(GL_LINE_STRIP);
 
+    // The color has to be set before the vertex,
+    // otherwise it belongs to the next vertex
     for(auto& s : shape.m_vertex)
     {
-        glVertex2f(s.position.x, s.position.y);
-        glColor4f(
-            rgba_to_gl(s.color.r),
-            rgba_to_gl(s.color.g),
-            rgba_to_gl(s.color.b),
-            rgba_to_gl(s.color.a)
-        );
+        glColor4ub(s.color.r, s.color.g, s.color.b, s.color.a);
+        vertex(matrix, s.position.x, s.position.y);
     }
 
     glEnd();
@@ -167,9 +198,18 @@ void GLFunctions::draw(const Shape& shape) noexcept
 
 void GLFunctions::draw(const Sprite& sprite) noexcept
 {
-    glTranslatef(sprite.m_translate.x, sprite.m_translate.y, 0.f);
-    glRotatef(sprite.m_degree, 0.f, 0.f, 1.f);
-    glScalef(sprite.m_scale.x, sprite.m_scale.y, 0.f);
+    GFX_PROFILE_ZONE("draw sprite");
+    // Async sprites are not drawn until they are ready
+    if(!sprite.resolve())
+        return;
+
+    const Matrix matrix = transform(sprite);
+
+    if(batching())
+    {
+        m_renderer.m_batch.add(sprite, matrix);
+        return;
+    }
 
     // Telling OpenGL that we are going to render
     // 2D Texture
@@ -178,14 +218,14 @@ void GLFunctions::draw(const Sprite& sprite) noexcept
 
     // Rendering all of the texture as a rectangle
     glBegin(GL_QUADS);
-    glTexCoord2f(0, 0);
-    glVertex2i(sprite.m_position.x, sprite.m_position.y);
-    glTexCoord2f(1, 0);
-    glVertex2i(sprite.m_position.x + sprite.m_geometry.width, sprite.m_position.y);
-    glTexCoord2f(1, 1);
-    glVertex2i(sprite.m_position.x + sprite.m_geometry.width, sprite.m_position.y + sprite.m_geometry.height);
-    glTexCoord2f(0, 1);
-    glVertex2i(sprite.m_position.x, sprite.m_position.y + sprite.m_geometry.height);
+    glTexCoord2f(sprite.m_uv_min.x, sprite.m_uv_min.y);
+    vertex(matrix, sprite.m_position.x, sprite.m_position.y);
+    glTexCoord2f(sprite.m_uv_max.x, sprite.m_uv_min.y);
+    vertex(matrix, sprite.m_position.x + sprite.m_geometry.width, sprite.m_position.y);
+    glTexCoord2f(sprite.m_uv_max.x, sprite.m_uv_max.y);
+    vertex(matrix, sprite.m_position.x + sprite.m_geometry.width, sprite.m_position.y + sprite.m_geometry.height);
+    glTexCoord2f(sprite.m_uv_min.x, sprite.m_uv_max.y);
+    vertex(matrix, sprite.m_position.x, sprite.m_position.y + sprite.m_geometry.height);
     glEnd();
 
     // All of the other shapes that coming after this 
@@ -195,4 +235,139 @@ void GLFunctions::draw(const Sprite& sprite) noexcept
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+// ------------------------------------------------------------ //
+
+void GLFunctions::draw_instanced(const std::vector<Rectangle>& rects) {
+    draw_instanced_shapes(rects);
+}
+
+void GLFunctions::draw_instanced(const std::vector<Circle>& circles) {
+    draw_instanced_shapes(circles);
+}
+
+template<typename T>
+void GLFunctions::draw_instanced_shapes(const std::vector<T>& shapes)
+{
+    GFX_PROFILE_ZONE("draw instanced");
+    if(!m_instancer && !m_renderer.m_software)
+        m_instancer.reset(new InstanceRenderer());
+
+    if(!m_instancer || !m_instancer->is_supported())
+    {
+        for(const auto& shape : shapes)
+            m_renderer.m_batch.add(shape, transform(shape));
+
+        // The immediate mode expects the shapes
+        // to be on the screen right away
+        if(m_mode == Mode::Immediate)
+            m_renderer.flush_batch();
+        return;
+    }
+
+    // Everything that was batched before
+    // has to be drawn first
+    m_renderer.flush_batch();
+    m_instancer->draw(shapes, m_transforms.back());
+}
+
+// ------------------------------------------------------------ //
+
+void GLFunctions::push_transform(const Transformation& transformation) {
+    m_transforms.push_back(m_transforms.back() * transformation.get_matrix());
+}
+
+void GLFunctions::push_transform(const Matrix& matrix) {
+    m_transforms.push_back(m_transforms.back() * matrix);
+}
+
+void GLFunctions::pop_transform()
+{
+    // The first matrix is the screen itself
+    if(m_transforms.size() <= 1)
+        throw std::logic_error("There is no transform to pop!");
+
+    m_transforms.pop_back();
+}
+
+const Matrix& GLFunctions::get_transform() const {
+    return m_transforms.back();
+}
+
+// ------------------------------------------------------------ //
+
+void GLFunctions::set_mode(Mode mode)
+{
+    m_renderer.flush_batch();
+    m_mode = mode;
+}
+
+GLFunctions::Mode GLFunctions::get_mode() const {
+    return m_mode;
+}
+
+void GLFunctions::flush() {
+    m_renderer.flush_batch();
+}
+
+void GLFunctions::submit(const DrawList& list)
+{
+    GFX_PROFILE_ZONE("submit draw list");
+
+    for(const Sprite* sprite : list.m_uploads)
+        sprite->resolve();
+
+    m_renderer.m_batch.append(list.m_batch);
+
+    // Immediate mode is drawing everything right away
+    if(!batching())
+        m_renderer.flush_batch();
+}
+
+void GLFunctions::submit(const std::vector<DrawList>& lists)
+{
+    for(const auto& list : lists)
+        submit(list);
+}
+
+// ------------------------------------------------------------ //
+
+Matrix GLFunctions::transform(const Transformation& transformation) const 
+{
+    // Nothing to multiply if there is no parent
+    if(m_transforms.size() == 1)
+        return transformation.get_matrix();
+
+    return m_transforms.back() * transformation.get_matrix();
+}
+
+void GLFunctions::begin_group(const std::string& label)
+{
+    if(!m_renderer.m_gpu_timer)
+        return;
+
+    m_renderer.flush_batch();
+    m_renderer.m_gpu_timer->begin_group(label);
+}
+
+void GLFunctions::end_group()
+{
+    if(!m_renderer.m_gpu_timer)
+        return;
+
+    m_renderer.flush_batch();
+    m_renderer.m_gpu_timer->end_group();
+}
+
+// ------------------------------------------------------------ //
+
+bool GLFunctions::batching() const {
+    return m_mode == Mode::Batched || m_renderer.m_software;
+}
+
+void GLFunctions::vertex(const Matrix& matrix, float x, float y) noexcept
+{
+    const VectorF point = matrix.apply(x, y);
+    glVertex2f(point.x, point.y);
+}
+
 END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "../include/gpu_timer.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+START_NAMESPACE
+
+static uint64_t cpu_now()
+{
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+static double to_ms(uint64_t begin, uint64_t end) {
+    return end > begin ? (end - begin) / 1e6 : 0.0;
+}
+
+// ------------------------------------------------------------ //
+
+GPUTimer::GPUTimer()
+    : m_first(0), m_count(0), m_recording(false), m_next_frame(0), m_skipped(0), m_dropped(0)
+{
+    m_available = m_gl.timer_queries();
+
+    // Some drivers have the functions, but
+    // their timestamps are always 0
+    if(m_available)
+    {
+        GLint bits = 0;
+        m_gl.get_query_iv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+        m_available = bits > 0;
+    }
+
+    for(auto& slot : m_slots)
+    {
+        slot.number = 0;
+        slot.stamps = 0;
+    }
+}
+
+GPUTimer::~GPUTimer()
+{
+    for(auto& slot : m_slots)
+    {
+        if(!slot.queries.empty())
+            m_gl.delete_queries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+}
+
+// ------------------------------------------------------------ //
+
+bool GPUTimer::is_available() const {
+    return m_available;
+}
+
+// ------------------------------------------------------------ //
+
+void GPUTimer::begin_frame()
+{
+    if(!m_available)
+        return;
+
+    const unsigned long number = m_next_frame++;
+
+    // The last frame never ended, its slot is reused
+    m_recording = false;
+    m_open_groups.clear();
+
+    // Making room for this frame without waiting
+    collect();
+    if(m_count == FRAMES)
+    {
+        m_skipped++;
+        return;
+    }
+
+    Slot& slot = m_slots[(m_first + m_count) % FRAMES];
+    slot.number = number;
+    slot.stamps = 0;
+    slot.markers.clear();
+
+    m_recording = true;
+    stamp(slot);
+}
+
+void GPUTimer::end_frame()
+{
+    if(!m_recording)
+        return;
+
+    // Groups that the user didn't end are ending with the frame
+    while(!m_open_groups.empty())
+        end_group();
+
+    stamp(m_slots[(m_first + m_count) % FRAMES]);
+
+    m_recording = false;
+    m_count++;
+}
+
+void GPUTimer::begin_group(const std::string& label)
+{
+    if(!m_recording)
+        return;
+
+    Slot& slot = m_slots[(m_first + m_count) % FRAMES];
+
+    Marker marker;
+    marker.label = label;
+    marker.depth = static_cast<unsigned int>(m_open_groups.size());
+    marker.begin = stamp(slot);
+    marker.end = marker.begin;
+
+    m_open_groups.push_back(slot.markers.size());
+    slot.markers.push_back(std::move(marker));
+}
+
+void GPUTimer::end_group()
+{
+    if(!m_recording)
+        return;
+
+    if(m_open_groups.empty())
+        throw std::logic_error("GPUTimer::end_group was called without begin_group");
+
+    Slot& slot = m_slots[(m_first + m_count) % FRAMES];
+    slot.markers[m_open_groups.back()].end = stamp(slot);
+    m_open_groups.pop_back();
+}
+
+// ------------------------------------------------------------ //
+
+bool GPUTimer::poll(Frame& frame)
+{
+    collect();
+
+    if(m_ready.empty())
+        return false;
+
+    frame = std::move(m_ready.front());
+    m_ready.pop_front();
+    return true;
+}
+
+size_t GPUTimer::get_skipped() const {
+    return m_skipped;
+}
+
+size_t GPUTimer::get_dropped() const {
+    return m_dropped;
+}
+
+// ------------------------------------------------------------ //
+
+size_t GPUTimer::stamp(Slot& slot)
+{
+    // The queries are created once and reused by every frame
+    if(slot.stamps == slot.queries.size())
+    {
+        const size_t count = slot.queries.empty() ? 8 : slot.queries.size();
+        slot.queries.resize(slot.queries.size() + count);
+        slot.cpu.resize(slot.queries.size());
+        m_gl.gen_queries(static_cast<GLsizei>(count), &slot.queries[slot.stamps]);
+    }
+
+    const size_t index = slot.stamps++;
+    m_gl.query_counter(slot.queries[index], GL_TIMESTAMP);
+    slot.cpu[index] = cpu_now();
+    return index;
+}
+
+void GPUTimer::collect()
+{
+    while(m_count > 0)
+    {
+        Slot& slot = m_slots[m_first];
+
+        // The queries are done in order, so if the last
+        // one is done every other one is done as well
+        GLint available = 0;
+        m_gl.get_query_object_iv(slot.queries[slot.stamps - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available)
+            return;
+
+        std::vector<GLuint64> gpu(slot.stamps);
+        for(size_t i = 0; i < slot.stamps; i++)
+            m_gl.get_query_object_ui64v(slot.queries[i], GL_QUERY_RESULT, &gpu[i]);
+
+        Frame frame;
+        frame.number = slot.number;
+        frame.gpu_ms = to_ms(gpu.front(), gpu.back());
+        frame.cpu_ms = to_ms(slot.cpu.front(), slot.cpu[slot.stamps - 1]);
+
+        for(const auto& marker : slot.markers)
+        {
+            frame.groups.push_back({
+                marker.label, marker.depth,
+                to_ms(gpu[marker.begin], gpu[marker.end]),
+                to_ms(slot.cpu[marker.begin], slot.cpu[marker.end])
+            });
+        }
+
+        // Nobody is polling, the oldest frame is thrown away
+        if(m_ready.size() == FRAMES)
+        {
+            m_ready.pop_front();
+            m_dropped++;
+        }
+
+        m_ready.push_back(std::move(frame));
+
+        m_first = (m_first + 1) % FRAMES;
+        m_count--;
+    }
+}
+
+END_NAMESPACE
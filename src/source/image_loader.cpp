@@ -0,0 +1,114 @@
+#include "../include/image_loader.hpp"
+#include "../include/utils/thread_pool.hpp"
+#include "../include/profiler.hpp"
+
+#include "../external_libs/stb_image.h"
+
+#include <map>
+#include <mutex>
+
+START_NAMESPACE
+
+// Only this file can see it
+namespace {
+
+struct Loader
+{
+    std::mutex mutex;
+    size_t workers = ThreadPool::hardware_workers();
+
+    // The images that are not decoded yet
+    std::map<std::string, ImageLoader::Result> loading;
+
+    // Declared last, so it's destroyed first while the
+    // workers can still use the members above
+    std::unique_ptr<ThreadPool> pool;
+}; // Loader
+
+} // namespace
+
+static Loader& loader()
+{
+    static Loader loader_;
+    return loader_;
+}
+
+// ------------------------------------------------------------ //
+
+ImageLoader::Result ImageLoader::load(const std::string& path)
+{
+    Loader& l = loader();
+    std::lock_guard<std::mutex> lock(l.mutex);
+
+    auto found = l.loading.find(path);
+    if(found != l.loading.end())
+        return found->second;
+
+    if(!l.pool)
+        l.pool.reset(new ThreadPool(l.workers));
+
+    Result result = l.pool->submit([path]() {
+        std::shared_ptr<const Image> image = decode(path);
+
+        // Whoever is holding the result can still use it
+        Loader& l = loader();
+        std::lock_guard<std::mutex> lock(l.mutex);
+        l.loading.erase(path);
+
+        return image;
+    }).share();
+
+    l.loading[path] = result;
+    return result;
+}
+
+std::shared_ptr<const ImageLoader::Image> ImageLoader::decode(const std::string& path)
+{
+    GFX_PROFILE_ZONE("decode image");
+
+    std::shared_ptr<Image> image = std::make_shared<Image>();
+
+    int width = 0;
+    int height = 0;
+    int nr_channels;
+
+    // Always 4 channels, so it can be uploaded as RGBA
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nr_channels, 4);
+    if(data)
+    {
+        image->pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+        image->size = {static_cast<unsigned int>(width), static_cast<unsigned int>(height)};
+        stbi_image_free(data);
+    }
+    else
+        image->size = {0, 0};
+
+    return image;
+}
+
+// ------------------------------------------------------------ //
+
+void ImageLoader::set_workers(size_t workers)
+{
+    std::unique_ptr<ThreadPool> last;
+
+    {
+        Loader& l = loader();
+        std::lock_guard<std::mutex> lock(l.mutex);
+
+        last = std::move(l.pool);
+        l.workers = workers == 0 ? 1 : workers;
+    }
+
+    // The last workers are finishing their images, they
+    // need the lock so it's done after it was unlocked
+    last.reset();
+}
+
+size_t ImageLoader::get_workers()
+{
+    std::lock_guard<std::mutex> lock(loader().mutex);
+    return loader().workers;
+}
+
+END_NAMESPACE
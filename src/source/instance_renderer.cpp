@@ -0,0 +1,303 @@
+#include "../include/instance_renderer.hpp"
+#include "../include/draws/rectangle.hpp"
+#include "../include/draws/circle.hpp"
+#include "../include/utils/tessellation.hpp"
+
+#include <cstddef>
+
+START_NAMESPACE
+
+// Attribute locations of the shader
+enum Attribute
+{
+    VERTEX = 0, RECT = 1, TRANSFORM = 2, DEGREE = 3, COLOR = 4
+};
+
+// The vertex is scaled by the size, and then transformed
+// exactly like glTranslatef * glRotatef * glScalef
+static const char* VERTEX_SHADER =
+    "#version 120\n"
+    "attribute vec2 a_vertex;\n"
+    "attribute vec4 a_rect;\n"
+    "attribute vec4 a_transform;\n"
+    "attribute float a_degree;\n"
+    "attribute vec4 a_color;\n"
+    "void main() {\n"
+    "    vec2 p = (a_rect.xy + a_vertex * a_rect.zw) * a_transform.zw;\n"
+    "    float r = radians(a_degree);\n"
+    "    float c = cos(r);\n"
+    "    float s = sin(r);\n"
+    "    p = vec2(p.x * c - p.y * s, p.x * s + p.y * c) + a_transform.xy;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(p, 0.0, 1.0);\n"
+    "    gl_FrontColor = a_color;\n"
+    "}\n";
+
+static const char* FRAGMENT_SHADER =
+    "#version 120\n"
+    "void main() {\n"
+    "    gl_FragColor = gl_Color;\n"
+    "}\n";
+
+// ------------------------------------------------------------ //
+
+InstanceRenderer::InstanceRenderer()
+    : m_supported(false), m_program(0), m_quad_buffer(0), m_instance_buffer(0)
+{
+    if(!m_gl.instancing() || !create_program())
+        return;
+
+    // The unit quad, it's used for both filled
+    // and outlined rectangles
+    const GLfloat quad[] = { 0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f };
+
+    m_gl.gen_buffers(1, &m_quad_buffer);
+    m_gl.bind_buffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    m_gl.buffer_data(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    m_gl.gen_buffers(1, &m_instance_buffer);
+    m_gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+
+    m_supported = true;
+}
+
+InstanceRenderer::~InstanceRenderer()
+{
+    if(m_quad_buffer)
+        m_gl.delete_buffers(1, &m_quad_buffer);
+    if(m_instance_buffer)
+        m_gl.delete_buffers(1, &m_instance_buffer);
+    for(auto& circle : m_circle_buffers)
+        m_gl.delete_buffers(1, &circle.second);
+    if(m_program)
+        m_gl.delete_program(m_program);
+}
+
+// ------------------------------------------------------------ //
+
+bool InstanceRenderer::is_supported() const {
+    return m_supported;
+}
+
+// ------------------------------------------------------------ //
+
+void InstanceRenderer::draw(const std::vector<Rectangle>& rects, const Matrix& parent)
+{
+    if(!m_supported || rects.empty())
+        return;
+
+    m_instances.clear();
+    m_fills.clear();
+
+    for(const auto& rect : rects)
+    {
+        m_instances.push_back({
+            static_cast<float>(rect.m_pos.x), static_cast<float>(rect.m_pos.y),
+            static_cast<float>(rect.m_size.width), static_cast<float>(rect.m_size.height),
+            static_cast<float>(rect.m_translate.x), static_cast<float>(rect.m_translate.y),
+            rect.m_scale.x, rect.m_scale.y,
+            static_cast<float>(rect.m_degree),
+            rect.m_color
+        });
+        m_fills.push_back(rect.m_fill);
+    }
+
+    submit({ m_quad_buffer, GL_TRIANGLE_FAN, 0, 4 }, { m_quad_buffer, GL_LINE_LOOP, 0, 4 }, parent);
+}
+
+void InstanceRenderer::draw(const std::vector<Circle>& circles, const Matrix& parent)
+{
+    if(!m_supported || circles.empty())
+        return;
+
+    m_instances.clear();
+    m_fills.clear();
+
+    // Every circle is using the same mesh, so it has
+    // to be smooth enough for the biggest circle
+    int segments = Tessellation::MIN_SEGMENTS;
+
+    for(const auto& circle : circles)
+    {
+        const Matrix scaled = parent * Matrix::scaling(circle.m_scale.x, circle.m_scale.y);
+        const int needed = Tessellation::segments(circle.m_radius, scaled);
+        if(needed > segments)
+            segments = needed;
+
+        m_instances.push_back({
+            static_cast<float>(circle.m_pos.x), static_cast<float>(circle.m_pos.y),
+            circle.m_radius, circle.m_radius,
+            static_cast<float>(circle.m_translate.x), static_cast<float>(circle.m_translate.y),
+            circle.m_scale.x, circle.m_scale.y,
+            static_cast<float>(circle.m_degree),
+            circle.m_color
+        });
+        m_fills.push_back(circle.m_fill);
+    }
+
+    const GLuint buffer = circle_buffer(segments);
+    submit(
+        { buffer, GL_TRIANGLE_FAN, 0, segments + 2 },
+        { buffer, GL_LINE_LOOP, segments + 2, segments }, parent);
+}
+
+// ------------------------------------------------------------ //
+
+bool InstanceRenderer::create_program()
+{
+    const char* sources[] = { VERTEX_SHADER, FRAGMENT_SHADER };
+    const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+
+    m_program = m_gl.create_program();
+
+    for(int i = 0; i < 2; i++)
+    {
+        GLuint shader = m_gl.create_shader(types[i]);
+        m_gl.shader_source(shader, 1, &sources[i], nullptr);
+        m_gl.compile_shader(shader);
+
+        GLint compiled = GL_FALSE;
+        m_gl.get_shader_iv(shader, GL_COMPILE_STATUS, &compiled);
+        if(compiled != GL_TRUE)
+        {
+            std::cout << "[GFX] Instancing shader couldn't compile, falling back to batching" << std::endl;
+            m_gl.delete_shader(shader);
+            return false;
+        }
+
+        // The program keeps the shader alive
+        m_gl.attach_shader(m_program, shader);
+        m_gl.delete_shader(shader);
+    }
+
+    m_gl.bind_attrib_location(m_program, VERTEX,    "a_vertex");
+    m_gl.bind_attrib_location(m_program, RECT,      "a_rect");
+    m_gl.bind_attrib_location(m_program, TRANSFORM, "a_transform");
+    m_gl.bind_attrib_location(m_program, DEGREE,    "a_degree");
+    m_gl.bind_attrib_location(m_program, COLOR,     "a_color");
+    m_gl.link_program(m_program);
+
+    GLint linked = GL_FALSE;
+    m_gl.get_program_iv(m_program, GL_LINK_STATUS, &linked);
+    if(linked != GL_TRUE)
+    {
+        std::cout << "[GFX] Instancing shader couldn't link, falling back to batching" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------ //
+
+GLuint InstanceRenderer::circle_buffer(int segments)
+{
+    auto found = m_circle_buffers.find(segments);
+    if(found != m_circle_buffers.end())
+        return found->second;
+
+    const VectorF* unit = Tessellation::unit_circle(segments);
+
+    std::vector<GLfloat> mesh;
+    mesh.reserve((segments * 2 + 2) * 2);
+
+    // Filled circle, a triangle fan around the center
+    mesh.push_back(0.f);
+    mesh.push_back(0.f);
+    for(int i = 0; i <= segments; i++)
+    {
+        mesh.push_back(unit[i].x);
+        mesh.push_back(unit[i].y);
+    }
+
+    // Outlined circle
+    for(int i = 0; i < segments; i++)
+    {
+        mesh.push_back(unit[i].x);
+        mesh.push_back(unit[i].y);
+    }
+
+    GLuint buffer;
+    m_gl.gen_buffers(1, &buffer);
+    m_gl.bind_buffer(GL_ARRAY_BUFFER, buffer);
+    m_gl.buffer_data(GL_ARRAY_BUFFER, mesh.size() * sizeof(GLfloat), mesh.data(), GL_STATIC_DRAW);
+    m_gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+
+    m_circle_buffers[segments] = buffer;
+    return buffer;
+}
+
+// ------------------------------------------------------------ //
+
+void InstanceRenderer::submit(const Mesh& fill, const Mesh& outline, const Matrix& parent)
+{
+    // Every instance is transformed on its own in the shader,
+    // the model view is holding the transform stack
+    const GLfloat modelview[16] = {
+        parent.a,  parent.b,  0.f, 0.f,
+        parent.c,  parent.d,  0.f, 0.f,
+        0.f,       0.f,       1.f, 0.f,
+        parent.tx, parent.ty, 0.f, 1.f
+    };
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadMatrixf(modelview);
+
+    m_gl.use_program(m_program);
+
+    m_gl.enable_vertex_attrib_array(VERTEX);
+
+    // Orphaning the last frame buffer, so the driver
+    // doesn't have to wait for the GPU to finish with it
+    m_gl.bind_buffer(GL_ARRAY_BUFFER, m_instance_buffer);
+    m_gl.buffer_data(GL_ARRAY_BUFFER, m_instances.size() * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    m_gl.buffer_sub_data(GL_ARRAY_BUFFER, 0, m_instances.size() * sizeof(Instance), m_instances.data());
+
+    const GLuint per_instance[] = { RECT, TRANSFORM, DEGREE, COLOR };
+    for(GLuint attribute : per_instance)
+    {
+        m_gl.enable_vertex_attrib_array(attribute);
+        m_gl.vertex_attrib_divisor(attribute, 1);
+    }
+
+    // Drawing every run of filled or outlined shapes
+    size_t first = 0;
+    while(first < m_instances.size())
+    {
+        size_t last = first;
+        while(last < m_instances.size() && m_fills[last] == m_fills[first])
+            last++;
+
+        const Mesh& mesh = m_fills[first] ? fill : outline;
+
+        // The unit mesh
+        m_gl.bind_buffer(GL_ARRAY_BUFFER, mesh.buffer);
+        m_gl.vertex_attrib_pointer(VERTEX, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+        // The instances of this run
+        m_gl.bind_buffer(GL_ARRAY_BUFFER, m_instance_buffer);
+        const char* base = reinterpret_cast<const char*>(first * sizeof(Instance));
+        m_gl.vertex_attrib_pointer(RECT,      4, GL_FLOAT, GL_FALSE, sizeof(Instance), base + offsetof(Instance, x));
+        m_gl.vertex_attrib_pointer(TRANSFORM, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), base + offsetof(Instance, tx));
+        m_gl.vertex_attrib_pointer(DEGREE,    1, GL_FLOAT, GL_FALSE, sizeof(Instance), base + offsetof(Instance, degree));
+        m_gl.vertex_attrib_pointer(COLOR,     4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), base + offsetof(Instance, color));
+
+        m_gl.draw_arrays_instanced(mesh.mode, mesh.first, mesh.count, static_cast<GLsizei>(last - first));
+
+        first = last;
+    }
+
+    // Making sure the other draws are not affected
+    for(GLuint attribute : per_instance)
+    {
+        m_gl.vertex_attrib_divisor(attribute, 0);
+        m_gl.disable_vertex_attrib_array(attribute);
+    }
+    m_gl.disable_vertex_attrib_array(VERTEX);
+    m_gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+    m_gl.use_program(0);
+
+    glPopMatrix();
+}
+
+END_NAMESPACE
\ No newline at end of file
@@ -1,40 +1,105 @@
 #include "../../../include/linux/input/keyboard.hpp"
+#include "../../../include/linux/renderer.hpp"
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <X11/keysymdef.h>
 
+#include <mutex>
+
 START_NAMESPACE
 
+// Only this file can see it
+namespace {
+
+// Opening a display is a full handshake with the X server,
+// so every call without a renderer is sharing one connection
+// that is never going to be used other than fetching the keys
+// because i don't want the user to be dependant on the renderer window.
+struct SharedDisplay
+{
+    Display* display;
+    std::mutex mutex;
+
+    SharedDisplay() 
+        : display(XOpenDisplay(nullptr)) {
+        abort_null(display, "Display couldn't to be created!");
+    }
+
+    ~SharedDisplay() {
+        XCloseDisplay(display);
+    }
+}; // SharedDisplay
+
+} // namespace
+
+static SharedDisplay& shared_display()
+{
+    static SharedDisplay shared;
+    return shared;
+}
+
+// Yes it's nasty, it's just checking if the correct
+// value was pressed, by checking it's bits correctly.
+static bool is_set(const char* keys, KeyCode code) {
+    return !!(keys[code >> 3] & (1 << (code & 7)));
+}
+
+// ------------------------------------------------------------ //
+
 bool Keyboard::key_pressed(Key key) {
     return key_pressed(static_cast<unsigned int>(key));
 }
 
 bool Keyboard::key_pressed(unsigned int key)
 {
-    // Creating a display that is never going to 
-    // be used other than fetching the keys
-    // because i don't want the user to
-    // be dependant on the renderer window.
-    Display* dpy = XOpenDisplay(":0");
+    SharedDisplay& shared = shared_display();
+    std::lock_guard<std::mutex> lock(shared.mutex);
 
     // All of the logical keys that the user
     // can press at once.
     char keys_return[32];
 
     // Getting all of the keycodes
-    XQueryKeymap(dpy, keys_return);
-    KeyCode kc2 = XKeysymToKeycode(dpy, key);
+    XQueryKeymap(shared.display, keys_return);
+    return is_set(keys_return, XKeysymToKeycode(shared.display, key));
+}
 
-    // Yes it's nasty, it's just checking if the correct
-    // value was pressed, by checking it's bits correctly.
-    bool is_pressed = !!(keys_return[kc2 >> 3] & (1 << (kc2 & 7)));
+// A headless renderer has no display, and
+// none of its keys is ever pressed
+static KeyCode keycode_of(Display* display, unsigned int key) {
+    return display ? XKeysymToKeycode(display, key) : 0;
+}
+
+// ------------------------------------------------------------ //
+
+bool Keyboard::key_pressed(Renderer& renderer, Key key) {
+    return key_pressed(renderer, static_cast<unsigned int>(key));
+}
 
-    // Closing the display, because it's finished fetching the keys.
-    XCloseDisplay(dpy);
+bool Keyboard::key_pressed(Renderer& renderer, unsigned int key) {
+    return is_set(renderer.keymap, keycode_of(renderer.display, key));
+}
+
+bool Keyboard::key_down(Renderer& renderer, Key key) {
+    return key_down(renderer, static_cast<unsigned int>(key));
+}
 
-    return is_pressed;
+bool Keyboard::key_down(Renderer& renderer, unsigned int key)
+{
+    const KeyCode code = keycode_of(renderer.display, key);
+    return is_set(renderer.keymap, code) && !is_set(renderer.last_keymap, code);
+}
+
+bool Keyboard::key_released(Renderer& renderer, Key key) {
+    return key_released(renderer, static_cast<unsigned int>(key));
+}
+
+bool Keyboard::key_released(Renderer& renderer, unsigned int key)
+{
+    const KeyCode code = keycode_of(renderer.display, key);
+    return !is_set(renderer.keymap, code) && is_set(renderer.last_keymap, code);
 }
 
 END_NAMESPACE
\ No newline at end of file
@@ -1,21 +1,81 @@
 #include "../../include/linux/renderer.hpp"
+#include "../../include/profiler.hpp"
+#include "../../include/texture_cache.hpp"
+
+#ifdef GFX_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <string>
+#include <cstring>
 
 START_NAMESPACE
 
 Renderer::Renderer(const Geometry& geometry)
-{
-    /*Parent*/ m_geometry = geometry;
-    create();
-}
+    : Renderer(geometry, Backend::OpenGL) {}
 
 Renderer::Renderer(unsigned int width, unsigned int height)
+    : Renderer(Geometry(width, height), Backend::OpenGL) {}
+
+Renderer::Renderer(unsigned int width, unsigned int height, Backend backend)
+    : Renderer(Geometry(width, height), backend) {}
+
+Renderer::Renderer(const Geometry& geometry, Backend backend)
+    : Renderer(geometry, backend, nullptr) {}
+
+Renderer::Renderer(unsigned int width, unsigned int height, Backend backend, ShareGroup* group)
+    : Renderer(Geometry(width, height), backend, group) {}
+
+Renderer::Renderer(const Geometry& geometry, Backend backend, ShareGroup* group)
+    : share_group(group)
 {
-    /*Parent*/ m_geometry = {width, height};
-    create();
+    /*Parent*/ m_geometry = geometry;
+    create(backend);
 }
 
 Renderer::~Renderer()
 {
+    // The queries have to be deleted while the context is still
+    // alive, the parent is destroyed only after it's gone
+    /*Parent*/ m_gpu_timer.reset();
+
+    if(/*Parent*/ m_software)
+        SoftwareRasterizer::make_current(nullptr);
+
+    // The other windows of the group are not sharing with it anymore,
+    // and the cache cannot find the textures of the context after it
+    void* native = context ? static_cast<void*>(context) : egl_context;
+    if(share_group && native)
+        share_group->leave(native);
+    else
+        TextureCache::drop_context(native);
+
+#ifdef GFX_EGL
+    // The display is shared with every headless window
+    // of the process, so it's never terminated
+    if(egl_context)
+    {
+        eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(egl_display, egl_context);
+        eglDestroySurface(egl_display, egl_surface);
+        eglReleaseThread();
+    }
+#endif
+
+    // A headless window has nothing else to destroy
+    if(!display)
+        return;
+
+    // The pixels are owned by the vector, so
+    // X shouldn't free them
+    if(image)
+    {
+        image->data = nullptr;
+        XDestroyImage(image);
+        XFreeGC(display, graphics_context);
+    }
+
     // Destroying the window and closing connection to X Server
     XDestroyWindow(display, window);
     XCloseDisplay(display);
@@ -31,6 +91,11 @@ Renderer& Renderer::get_renderer() /*override*/ {
 
 void Renderer::set_title(const std::string& title) /*override*/
 {
+    /*Parent*/ m_title = title;
+
+    if(!display)
+        return;
+
     // Changing the title variable into the title argument
     XStoreName(display, window, title.c_str());
     XChangeProperty(
@@ -42,8 +107,6 @@ void Renderer::set_title(const std::string& title) /*override*/
         PropModeReplace, 
         reinterpret_cast<unsigned char*>(const_cast<char*>(title.c_str())), 
         title.size());
-
-    /*Parent*/ m_title = title;
 }
 
 // ------------------------------------------------------------ //
@@ -51,31 +114,143 @@ void Renderer::set_title(const std::string& title) /*override*/
 bool Renderer::is_running() /*override*/
 {
     /*Parent*/ start_ticks = std::chrono::high_resolution_clock::now();
-    handle_events();
+    /*Parent*/ run_posted();
+
+    // There are no events without a window
+    if(display)
+    {
+        handle_events();
+        update_keymap();
+    }
+
     return running;
 }
 
 // ------------------------------------------------------------ //
 
-void Renderer::swap_buffers() /*override*/ {
-    glXSwapBuffers(display, window);
+void Renderer::swap_buffers() /*override*/ 
+{
+    GFX_PROFILE_ZONE("swap buffers");
+
+    // Submitting everything that was drawn in batched mode
+    /*Parent*/ flush_batch();
+
+    if(/*Parent*/ m_gpu_timer)
+        /*Parent*/ m_gpu_timer->end_frame();
+
+    // Nothing is displayed, the frame is only kept
+    if(/*Parent*/ m_headless)
+        /*Parent*/ capture_frame();
+    else if(/*Parent*/ m_software)
+        present_software();
+    else
+        glXSwapBuffers(display, window);
+
+    int64_t ust, msc = -1, sbc;
+    if(get_sync_values && !get_sync_values(display, window, &ust, &msc, &sbc))
+        msc = -1;
+
+    /*Parent*/ record_swap(msc);
 }
 
 // ------------------------------------------------------------ //
 
-void Renderer::create() noexcept
+bool Renderer::set_swap_interval(int interval) /*override*/
 {
-    init_members();
-    create_opengl_context();
-    init_events();
-    
-    running = true;
+    if(interval < 0 && !adaptive_swap)
+        return false;
+
+    if(swap_interval_ext)
+    {
+        swap_interval_ext(display, window, interval);
+
+        // The driver is telling which interval it's really using
+        unsigned int current = 0;
+        glXQueryDrawable(display, window, GLX_SWAP_INTERVAL_EXT, &current);
+
+        // Adaptive vsync is reported with a separate flag
+        unsigned int late_swaps_tear = 0;
+        if(adaptive_swap)
+            glXQueryDrawable(display, window, GLX_LATE_SWAPS_TEAR_EXT, &late_swaps_tear);
+
+        /*Parent*/ m_frame_stats.swap_interval = late_swaps_tear ? -static_cast<int>(current) : static_cast<int>(current);
+        return /*Parent*/ m_frame_stats.swap_interval == interval;
+    }
+
+    if(swap_interval_mesa)
+    {
+        swap_interval_mesa(static_cast<unsigned int>(interval));
+        /*Parent*/ m_frame_stats.swap_interval = get_swap_interval_mesa();
+        return /*Parent*/ m_frame_stats.swap_interval == interval;
+    }
+
+    // The SGI extension cannot turn the vsync off
+    if(swap_interval_sgi && interval > 0 && swap_interval_sgi(interval) == 0)
+    {
+        /*Parent*/ m_frame_stats.swap_interval = interval;
+        return true;
+    }
+
+    return false;
 }
 
 // ------------------------------------------------------------ //
 
-void Renderer::init_members() noexcept
-{ 
+void Renderer::make_current() /*override*/
+{
+    if(/*Parent*/ m_software)
+    {
+        SoftwareRasterizer::make_current(m_software.get());
+        return;
+    }
+
+#ifdef GFX_EGL
+    if(egl_context)
+    {
+        eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context);
+        return;
+    }
+#endif
+
+    glXMakeCurrent(display, window, context);
+}
+
+void Renderer::release_current() /*override*/
+{
+    if(/*Parent*/ m_software)
+    {
+        SoftwareRasterizer::make_current(nullptr);
+        return;
+    }
+
+#ifdef GFX_EGL
+    if(egl_context)
+    {
+        eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        return;
+    }
+#endif
+
+    glXMakeCurrent(display, None, nullptr);
+}
+
+// ------------------------------------------------------------ //
+
+void Renderer::create(Backend backend) noexcept
+{
+    init_members();
+
+    if(backend == Backend::Headless || backend == Backend::HeadlessSoftware)
+    {
+        /*Parent*/ m_headless = true;
+
+        if(backend == Backend::HeadlessSoftware || !create_headless_context())
+            create_software_renderer();
+
+        running = true;
+        return;
+    }
+
     // Connecting to the X server and making sure
     // everything was OK
     display = XOpenDisplay(nullptr);
@@ -84,6 +259,44 @@ void Renderer::init_members() noexcept
     // getting the current screen
     screen = DefaultScreenOfDisplay(display);
     screen_id = DefaultScreen(display);
+
+    if(backend == Backend::Software)
+        create_software_window();
+    else
+        create_opengl_context();
+
+    init_events();
+    
+    running = true;
+}
+
+// ------------------------------------------------------------ //
+
+void Renderer::init_members() noexcept
+{ 
+    // A headless window is never connecting to the X server
+    display = nullptr;
+    screen = nullptr;
+    screen_id = 0;
+    button_pressed = 0;
+
+    // Only one of the backends is going to create them
+    egl_display = egl_surface = egl_context = nullptr;
+    swap_interval_ext = nullptr;
+    swap_interval_mesa = nullptr;
+    get_swap_interval_mesa = nullptr;
+    swap_interval_sgi = nullptr;
+    adaptive_swap = false;
+    get_sync_values = nullptr;
+    vi = nullptr;
+    context = nullptr;
+    image = nullptr;
+    graphics_context = nullptr;
+    red_shift = green_shift = blue_shift = 0;
+
+    // No key is pressed before the first frame
+    std::memset(keymap, 0, sizeof(keymap));
+    std::memset(last_keymap, 0, sizeof(last_keymap));
 }
 
 // ------------------------------------------------------------ //
@@ -130,35 +343,296 @@ void Renderer::create_opengl_context() noexcept
         CWBackPixel | CWColormap | CWBorderPixel | CWEventMask, 
         &window_attribs);
 
-    context = glXCreateContext(display, vi, nullptr, true);
-    glXMakeCurrent(display, window, context);
+    // Sharing with a context of the group, it's created on its
+    // own if the other context is on another X server
+    void* share = nullptr;
+    bool joined = share_group && share_group->begin_join(ShareGroup::Api::GLX, share);
 
-    // Making sure the window cannot be scaled down or up
-    XSizeHints hints;
-    hints.min_width = m_geometry.width;
-    hints.min_height = m_geometry.height;
-    hints.max_width = m_geometry.width;
-    hints.max_height = m_geometry.height;
-    XSetWMNormalHints(display, window, &hints);
+    context = glXCreateContext(display, vi, static_cast<GLXContext>(share), true);
+    if(!context && share)
+    {
+        context = glXCreateContext(display, vi, nullptr, true);
+        joined = false;
+    }
+
+    if(share_group)
+        share_group->end_join(joined ? context : nullptr);
+
+    glXMakeCurrent(display, window, context);
 
     std::cout << "[LINUX] GL Vendor: " << glGetString(GL_VENDOR) << std::endl;
     std::cout << "[LINUX] GL Renderer: " << glGetString(GL_RENDERER) << std::endl;
     std::cout << "[LINUX] GL Version: " << glGetString(GL_VERSION) << std::endl;
     std::cout << "[LINUX] GL Shading Language: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
+
+    init_swap_control();
+}
+
+void Renderer::init_swap_control() noexcept
+{
+    const std::string extensions = std::string(" ") + glXQueryExtensionsString(display, screen_id) + " ";
+    auto has_extension = [&extensions](const char* name) {
+        return extensions.find(std::string(" ") + name + " ") != std::string::npos;
+    };
+
+    auto load = [](const char* name) {
+        return glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name));
+    };
+
+    // The EXT extension is the only one that is per window and can
+    // be adaptive, MESA is the next best one since it can be queried
+    if(has_extension("GLX_EXT_swap_control"))
+    {
+        swap_interval_ext = reinterpret_cast<PFNGLXSWAPINTERVALEXTPROC>(load("glXSwapIntervalEXT"));
+        adaptive_swap = has_extension("GLX_EXT_swap_control_tear");
+        /*Parent*/ m_swap_control = "GLX_EXT_swap_control";
+
+        unsigned int current = 0;
+        glXQueryDrawable(display, window, GLX_SWAP_INTERVAL_EXT, &current);
+        /*Parent*/ m_frame_stats.swap_interval = static_cast<int>(current);
+    }
+    else if(has_extension("GLX_MESA_swap_control"))
+    {
+        swap_interval_mesa = reinterpret_cast<PFNGLXSWAPINTERVALMESAPROC>(load("glXSwapIntervalMESA"));
+        get_swap_interval_mesa = reinterpret_cast<PFNGLXGETSWAPINTERVALMESAPROC>(load("glXGetSwapIntervalMESA"));
+        /*Parent*/ m_swap_control = "GLX_MESA_swap_control";
+        /*Parent*/ m_frame_stats.swap_interval = get_swap_interval_mesa ? get_swap_interval_mesa() : 1;
+
+        if(!swap_interval_mesa || !get_swap_interval_mesa)
+        {
+            swap_interval_mesa = nullptr;
+            /*Parent*/ m_swap_control.clear();
+        }
+    }
+    else if(has_extension("GLX_SGI_swap_control"))
+    {
+        swap_interval_sgi = reinterpret_cast<PFNGLXSWAPINTERVALSGIPROC>(load("glXSwapIntervalSGI"));
+        /*Parent*/ m_swap_control = "GLX_SGI_swap_control";
+
+        // The default of the SGI extension, it cannot be queried
+        /*Parent*/ m_frame_stats.swap_interval = 1;
+    }
+
+    if(has_extension("GLX_OML_sync_control"))
+    {
+        get_sync_values = reinterpret_cast<PFNGLXGETSYNCVALUESOMLPROC>(load("glXGetSyncValuesOML"));
+
+        auto get_msc_rate = reinterpret_cast<PFNGLXGETMSCRATEOMLPROC>(load("glXGetMscRateOML"));
+        int32_t numerator = 0, denominator = 0;
+        if(get_msc_rate && get_msc_rate(display, window, &numerator, &denominator) && denominator != 0)
+            /*Parent*/ m_frame_stats.refresh_rate = static_cast<double>(numerator) / denominator;
+    }
+}
+
+// ------------------------------------------------------------ //
+
+// Where the top bit of a channel has to move in order to fit
+// into the mask, it's negative when the channel is smaller
+static int shift_of(unsigned long mask)
+{
+    int top = -1;
+    for(int i = 0; mask >> i; i++)
+        top = i;
+
+    return top - 7;
+}
+
+// Moving a channel into its place inside of a pixel
+static uint32_t place(unsigned char channel, int shift, unsigned long mask)
+{
+    const unsigned long value = shift >= 0 ? 
+        static_cast<unsigned long>(channel) << shift : 
+        static_cast<unsigned long>(channel) >> -shift;
+
+    return static_cast<uint32_t>(value & mask);
+}
+
+void Renderer::create_software_window() noexcept
+{
+    Visual* visual = DefaultVisual(display, screen_id);
+    const int depth = DefaultDepth(display, screen_id);
+
+    XSetWindowAttributes window_attribs;
+    window_attribs.border_pixel = BlackPixel(display, screen_id);
+    window_attribs.background_pixel = BlackPixel(display, screen_id);
+    window_attribs.event_mask = ExposureMask;
+
+    // A plain window without an OpenGL context
+    window = XCreateWindow(
+        display, 
+        RootWindow(display, screen_id), 
+        0, 0, 
+        m_geometry.width, m_geometry.height, 
+        0, 
+        depth,
+        InputOutput, 
+        visual, 
+        CWBackPixel | CWBorderPixel | CWEventMask, 
+        &window_attribs);
+
+    graphics_context = XCreateGC(display, window, 0, nullptr);
+
+    // The image is using the pixels of the vector
+    image_pixels.resize(static_cast<size_t>(m_geometry.width) * m_geometry.height);
+    image = XCreateImage(
+        display, visual, depth, ZPixmap, 0, 
+        reinterpret_cast<char*>(image_pixels.data()), 
+        m_geometry.width, m_geometry.height, 32, 0);
+
+    if(image && image->bits_per_pixel != 32)
+    {
+        image->data = nullptr;
+        XDestroyImage(image);
+        image = nullptr;
+    }
+    abort_null(image, "The software backend needs a 32 bit window!");
+
+    red_shift   = shift_of(image->red_mask);
+    green_shift = shift_of(image->green_mask);
+    blue_shift  = shift_of(image->blue_mask);
+
+    create_software_renderer();
+}
+
+void Renderer::create_software_renderer() noexcept
+{
+    // The textures of this thread are created by the rasterizer
+    /*Parent*/ m_software.reset(new SoftwareRasterizer(m_geometry));
+    SoftwareRasterizer::make_current(m_software.get());
+
+    std::cout << "[LINUX] Software renderer, " << m_software->get_worker_count() + 1 << " threads" << std::endl;
+}
+
+void Renderer::present_software() noexcept
+{
+    // Converting every RGBA pixel into the pixels of the window
+    const Color* pixels = /*Parent*/ m_software->get_pixels();
+    for(size_t i = 0; i < image_pixels.size(); i++)
+    {
+        image_pixels[i] = 
+            place(pixels[i].r, red_shift,   image->red_mask) |
+            place(pixels[i].g, green_shift, image->green_mask) |
+            place(pixels[i].b, blue_shift,  image->blue_mask);
+    }
+
+    XPutImage(display, window, graphics_context, image, 0, 0, 0, 0, m_geometry.width, m_geometry.height);
+    XFlush(display);
+}
+
+// ------------------------------------------------------------ //
+
+bool Renderer::create_headless_context() noexcept
+{
+#ifdef GFX_EGL
+    EGLDisplay egl = EGL_NO_DISPLAY;
+
+    // Mesa can create a display without an X server or a GPU,
+    // the other drivers are using their default display
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if(extensions && std::strstr(extensions, "EGL_MESA_platform_surfaceless"))
+    {
+        auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+        if(get_platform_display)
+            egl = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+#endif
+
+    if(egl == EGL_NO_DISPLAY)
+        egl = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if(egl == EGL_NO_DISPLAY || !eglInitialize(egl, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API))
+        return false;
+
+    // The same buffers the window is asking for
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_ALPHA_SIZE,      8,
+        EGL_DEPTH_SIZE,      24,
+        EGL_STENCIL_SIZE,    8,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint count = 0;
+    if(!eglChooseConfig(egl, config_attribs, &config, 1, &count) || count == 0)
+        return false;
+
+    const EGLint surface_attribs[] = {
+        EGL_WIDTH,  static_cast<EGLint>(m_geometry.width),
+        EGL_HEIGHT, static_cast<EGLint>(m_geometry.height),
+        EGL_NONE
+    };
+
+    EGLSurface surface = eglCreatePbufferSurface(egl, config, surface_attribs);
+    if(surface == EGL_NO_SURFACE)
+        return false;
+
+    void* share = nullptr;
+    bool joined = share_group && share_group->begin_join(ShareGroup::Api::EGL, share);
+
+    EGLContext created = eglCreateContext(egl, config, share ? share : EGL_NO_CONTEXT, nullptr);
+    if(created == EGL_NO_CONTEXT && share)
+    {
+        created = eglCreateContext(egl, config, EGL_NO_CONTEXT, nullptr);
+        joined = false;
+    }
+
+    if(created == EGL_NO_CONTEXT || !eglMakeCurrent(egl, surface, surface, created))
+    {
+        if(share_group)
+            share_group->end_join(nullptr);
+
+        if(created != EGL_NO_CONTEXT)
+            eglDestroyContext(egl, created);
+        eglDestroySurface(egl, surface);
+        return false;
+    }
+
+    if(share_group)
+        share_group->end_join(joined ? created : nullptr);
+
+    egl_display = egl;
+    egl_surface = surface;
+    egl_context = created;
+
+    std::cout << "[LINUX] Headless GL Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    std::cout << "[LINUX] Headless GL Version: " << glGetString(GL_VERSION) << std::endl;
+    return true;
+#else
+    return false;
+#endif
 }
 
 // ------------------------------------------------------------ //
 
 void Renderer::init_events() noexcept
 {
+    // Making sure the window cannot be scaled down or up
+    XSizeHints hints;
+    hints.flags = PMinSize | PMaxSize;
+    hints.min_width = m_geometry.width;
+    hints.min_height = m_geometry.height;
+    hints.max_width = m_geometry.width;
+    hints.max_height = m_geometry.height;
+    XSetWMNormalHints(display, window, &hints);
+
     // Process the window close event with the destructor
     del_window = XInternAtom(display, "WM_DELETE_WINDOW", 0);
     XSetWMProtocols(display, window, &del_window, 1);
 
     // The only events i'm going to use
-    // are checking if a button has been pressed
-    // or if the mouse was moved
-    XSelectInput(display, window, PointerMotionMask | ButtonPressMask | KeyPressMask | FocusChangeMask);
+    // are checking if a button or a key has been pressed
+    // or released, or if the mouse was moved
+    XSelectInput(display, window, 
+        PointerMotionMask | ButtonPressMask | ButtonReleaseMask | 
+        KeyPressMask | KeyReleaseMask | FocusChangeMask);
 
     // Clears the entire Renderer and making sure 
     // Nothing is being displayed
@@ -170,13 +644,14 @@ void Renderer::init_events() noexcept
 
 void Renderer::handle_events() noexcept
 {
+    GFX_PROFILE_ZONE("handle events");
+
     button_pressed = 0;
     
-    // Clening all of the pending events
-    // and extract only the mouse position
+    // Clening all of the pending events, every input
+    // event is also kept for the user in the events queue
     while (XPending(display))
     {
-        XCheckWindowEvent(display, window, 1, &ev);
         XNextEvent(display, &ev);
 
         // When user in the window
@@ -201,13 +676,99 @@ void Renderer::handle_events() noexcept
             {
                 mouse_pos.x = ev.xmotion.x;
                 mouse_pos.y = ev.xmotion.y;
+
+                /*Parent*/ push_event(InputEvent(InputEvent::Type::Motion, 0, mouse_pos));
             }
 
             // Mouse button
-            else if(ev.type == ButtonPress)
-                button_pressed = ev.xbutton.button;
+            else if(ev.type == ButtonPress || ev.type == ButtonRelease)
+                handle_button(ev.xbutton);
+
+            // Keyboard
+            else if(ev.type == KeyPress || ev.type == KeyRelease)
+                handle_key(ev.xkey);
+        }
+    }
+}
+
+void Renderer::handle_button(const XButtonEvent& button) noexcept
+{
+    const VectorI position(button.x, button.y);
+
+    // Buttons 4 to 7 are the scroll wheel, X is sending
+    // a press and a release for every step
+    if(button.button >= 4 && button.button <= 7)
+    {
+        if(button.type == ButtonRelease)
+            return;
+
+        // The old way of fetching the scroll
+        button_pressed = button.button;
+
+        InputEvent event(InputEvent::Type::Scroll, button.button, position);
+        switch(button.button)
+        {
+        case 4: event.scroll.y =  1; break;
+        case 5: event.scroll.y = -1; break;
+        case 6: event.scroll.x = -1; break;
+        case 7: event.scroll.x =  1; break;
+        }
+
+        /*Parent*/ push_event(event);
+        return;
+    }
+
+    if(button.type == ButtonPress)
+    {
+        button_pressed = button.button;
+        /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonPressed, button.button, position));
+    }
+    else
+        /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonReleased, button.button, position));
+}
+
+void Renderer::handle_key(XKeyEvent& key) noexcept
+{
+    const VectorI position(key.x, key.y);
+
+    // The keys are always upper case, exactly like Keyboard::Key
+    KeySym lower, upper;
+    XConvertCase(XLookupKeysym(&key, 0), &lower, &upper);
+    const unsigned int code = static_cast<unsigned int>(upper);
+
+    if(key.type == KeyPress)
+    {
+        /*Parent*/ push_event(InputEvent(InputEvent::Type::KeyPressed, code, position));
+        return;
+    }
+
+    // When a key is held X is sending a release and a press
+    // at the same time, it's a single repeated press
+    if(XEventsQueued(display, QueuedAfterReading))
+    {
+        XEvent next;
+        XPeekEvent(display, &next);
+
+        if(next.type == KeyPress && next.xkey.time == key.time && next.xkey.keycode == key.keycode)
+        {
+            XNextEvent(display, &next);
+
+            InputEvent event(InputEvent::Type::KeyPressed, code, position);
+            event.repeat = true;
+            /*Parent*/ push_event(event);
+            return;
         }
     }
+
+    /*Parent*/ push_event(InputEvent(InputEvent::Type::KeyReleased, code, position));
+}
+
+// ------------------------------------------------------------ //
+
+void Renderer::update_keymap() noexcept
+{
+    std::memcpy(last_keymap, keymap, sizeof(keymap));
+    XQueryKeymap(display, keymap);
 }
 
 END_NAMESPACE
\ No newline at end of file
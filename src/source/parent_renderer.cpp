@@ -1,13 +1,30 @@
 #include "../include/parent_renderer.hpp"
+#include "../include/profiler.hpp"
 
 #ifdef _WIN32
 #include "../include/windows/renderer.hpp"
+#include <gl/gl.h>
 #elif __linux__
 #include "../include/linux/renderer.hpp"
 #endif
 
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
 START_NAMESPACE
 
+ParentRenderer::ParentRenderer()
+    : running(false), focused(false), m_dropped_events(0), m_rejected_posts(0),
+      m_headless(false), m_capture(true), m_frame_number(0)
+{
+    m_frame_stats.swap_interval = 0;
+    m_frame_stats.refresh_rate = 0.0;
+    reset_frame_stats();
+}
+
+// ------------------------------------------------------------ //
+
 const std::string& ParentRenderer::get_title() const {
     return m_title;
 }
@@ -42,8 +59,264 @@ double ParentRenderer::get_framerate() const
 
 // ------------------------------------------------------------ //
 
+const std::string& ParentRenderer::get_swap_control() const {
+    return m_swap_control;
+}
+
+const ParentRenderer::FrameStats& ParentRenderer::get_frame_stats() const {
+    return m_frame_stats;
+}
+
+void ParentRenderer::reset_frame_stats()
+{
+    // The interval and the refresh rate are kept
+    m_frame_stats.frames = 0;
+    m_frame_stats.last_frame_ms = 0.0;
+    m_frame_stats.average_frame_ms = 0.0;
+    m_frame_stats.achieved_interval = 0.0;
+    m_frame_stats.missed_deadlines = 0;
+    m_frame_stats.worst_late_ms = 0.0;
+    m_first_vblank = -1;
+}
+
+void ParentRenderer::record_swap(int64_t vblank)
+{
+    using namespace std::chrono;
+
+    const steady_clock::time_point now = steady_clock::now();
+    FrameStats& stats = m_frame_stats;
+
+    // The first frame has nothing to be measured from
+    if(stats.frames > 0)
+    {
+        stats.last_frame_ms = duration<double, std::milli>(now - m_last_swap).count();
+        stats.average_frame_ms += (stats.last_frame_ms - stats.average_frame_ms) / stats.frames;
+    }
+
+    if(vblank < 0)
+        stats.achieved_interval = 0.0;
+    else if(m_first_vblank < 0 || stats.frames == 0)
+        m_first_vblank = vblank;
+    else
+        stats.achieved_interval = static_cast<double>(vblank - m_first_vblank) / stats.frames;
+
+    stats.frames++;
+    m_last_swap = now;
+}
+
+// ------------------------------------------------------------ //
+
+void ParentRenderer::set_target_fps(double fps) {
+    m_limiter.set_target(fps);
+}
+
+double ParentRenderer::get_target_fps() const {
+    return m_limiter.get_target();
+}
+
+void ParentRenderer::wait_for_next_frame()
+{
+    GFX_PROFILE_ZONE("wait for next frame");
+
+    if(!m_limiter.wait())
+        record_missed_deadline();
+}
+
+int64_t ParentRenderer::schedule_next_frame()
+{
+    if(!m_limiter.advance())
+        record_missed_deadline();
+
+    return m_limiter.get_deadline();
+}
+
+void ParentRenderer::record_missed_deadline()
+{
+    m_frame_stats.missed_deadlines++;
+    m_frame_stats.worst_late_ms = std::max(m_frame_stats.worst_late_ms, m_limiter.get_last_late_ms());
+}
+
+// ------------------------------------------------------------ //
+
+bool ParentRenderer::post(std::function<void()> task)
+{
+    if(m_posted.push(std::move(task)))
+        return true;
+
+    m_rejected_posts++;
+    return false;
+}
+
+size_t ParentRenderer::get_rejected_posts() const {
+    return m_rejected_posts;
+}
+
+void ParentRenderer::run_posted()
+{
+    if(m_posted.empty())
+        return;
+
+    GFX_PROFILE_ZONE("run posted tasks");
+
+    // Producers that keep posting cannot hold the frame forever
+    std::function<void()> task;
+    for(size_t count = m_posted.size(); count > 0 && m_posted.pop(task); count--)
+        task();
+}
+
+// ------------------------------------------------------------ //
+
 bool ParentRenderer::is_focused() const {
     return focused;
 }
 
+// ------------------------------------------------------------ //
+
+ParentRenderer::Backend ParentRenderer::get_backend() const {
+    return m_software ? Backend::Software : Backend::OpenGL;
+}
+
+const SoftwareRasterizer* ParentRenderer::get_rasterizer() const {
+    return m_software.get();
+}
+
+// ------------------------------------------------------------ //
+
+bool ParentRenderer::is_headless() const {
+    return m_headless;
+}
+
+const std::vector<Color>& ParentRenderer::get_frame() const {
+    return m_frame;
+}
+
+void ParentRenderer::set_capture(bool capture) {
+    m_capture = capture;
+}
+
+bool ParentRenderer::save_frame(const std::string& path) const
+{
+    if(m_frame.empty())
+        return false;
+
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+        return false;
+
+    // PPM has no alpha, so only the colors are written
+    file << "P6\n" << m_geometry.width << ' ' << m_geometry.height << "\n255\n";
+
+    std::vector<unsigned char> rgb(m_frame.size() * 3);
+    for(size_t i = 0; i < m_frame.size(); i++)
+    {
+        rgb[i * 3 + 0] = m_frame[i].r;
+        rgb[i * 3 + 1] = m_frame[i].g;
+        rgb[i * 3 + 2] = m_frame[i].b;
+    }
+
+    file.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+    return static_cast<bool>(file);
+}
+
+void ParentRenderer::set_frame_output(const std::string& prefix) {
+    m_frame_output = prefix;
+}
+
+// ------------------------------------------------------------ //
+
+bool ParentRenderer::set_gpu_timing(bool enabled)
+{
+    m_gpu_timer.reset();
+
+    if(!enabled || m_software)
+        return false;
+
+    m_gpu_timer.reset(new GPUTimer());
+    if(!m_gpu_timer->is_available())
+    {
+        m_gpu_timer.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool ParentRenderer::poll_gpu_timing(GPUTimer::Frame& frame) {
+    return m_gpu_timer && m_gpu_timer->poll(frame);
+}
+
+// ------------------------------------------------------------ //
+
+bool ParentRenderer::poll_event(InputEvent& event) {
+    return m_events.pop(event);
+}
+
+size_t ParentRenderer::get_dropped_events() const {
+    return m_dropped_events;
+}
+
+void ParentRenderer::push_event(const InputEvent& event)
+{
+    // The newest events are the ones that are lost,
+    // so the order of the events is always kept
+    if(!m_events.push(event))
+        m_dropped_events++;
+}
+
+// ------------------------------------------------------------ //
+
+void ParentRenderer::flush_batch()
+{
+    GFX_PROFILE_ZONE("flush batch");
+    if(!m_software)
+    {
+        m_batch.flush();
+        return;
+    }
+
+    m_software->draw(m_batch);
+    m_batch.clear();
+}
+
+void ParentRenderer::capture_frame()
+{
+    GFX_PROFILE_ZONE("capture frame");
+    const unsigned long number = m_frame_number++;
+
+    if(!m_capture && m_frame_output.empty())
+    {
+        // Nothing is waiting for the GPU, the
+        // commands only have to be submitted
+        if(!m_software)
+            glFlush();
+        return;
+    }
+
+    const size_t pixels = static_cast<size_t>(m_geometry.width) * m_geometry.height;
+    if(m_software)
+        m_frame.assign(m_software->get_pixels(), m_software->get_pixels() + pixels);
+    else
+    {
+        std::vector<Color> flipped(pixels);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, m_geometry.width, m_geometry.height, GL_RGBA, GL_UNSIGNED_BYTE, flipped.data());
+
+        // OpenGL starts from the bottom row
+        m_frame.resize(pixels);
+        for(unsigned int y = 0; y < m_geometry.height; y++)
+        {
+            const Color* row = &flipped[(m_geometry.height - y - 1) * m_geometry.width];
+            std::copy(row, row + m_geometry.width, &m_frame[y * m_geometry.width]);
+        }
+    }
+
+    if(!m_frame_output.empty())
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "%06lu.ppm", number);
+        save_frame(m_frame_output + suffix);
+    }
+}
+
 END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "../include/pixel_reader.hpp"
+#include "../include/software_rasterizer.hpp"
+
+#ifdef _WIN32
+#include "../include/windows/renderer.hpp"
+#elif __linux__
+#include "../include/linux/renderer.hpp"
+#endif
+
+#include <algorithm>
+
+START_NAMESPACE
+
+Color PixelReader::Region::get_pixel(unsigned int x, unsigned int y) const {
+    return pixels[y * size.width + x];
+}
+
+// ------------------------------------------------------------ //
+
+PixelReader::PixelReader(const Renderer& renderer)
+    : m_renderer(renderer), m_first(0), m_count(0), m_next_ticket(0)
+{
+    // Pixel buffers are core since OpenGL 2.1, the software
+    // rasterizer has no context and its frame is already in memory
+    m_async = !renderer.get_rasterizer() && m_gl.buffers() &&
+        (m_gl.has_version(2, 1) || m_gl.has_extension("GL_ARB_pixel_buffer_object"));
+
+    for(auto& slot : m_slots)
+    {
+        slot.buffer = 0;
+        slot.capacity = 0;
+        slot.fence = nullptr;
+
+        if(m_async)
+            m_gl.gen_buffers(1, &slot.buffer);
+    }
+}
+
+PixelReader::~PixelReader()
+{
+    for(auto& slot : m_slots)
+    {
+        if(slot.fence)
+            m_gl.delete_sync(slot.fence);
+        if(slot.buffer)
+            m_gl.delete_buffers(1, &slot.buffer);
+    }
+}
+
+// ------------------------------------------------------------ //
+
+bool PixelReader::is_async() const {
+    return m_async;
+}
+
+// ------------------------------------------------------------ //
+
+unsigned long PixelReader::request() {
+    return request({0, 0}, m_renderer.get_geometry());
+}
+
+unsigned long PixelReader::request(const VectorUI& position, const Geometry& size)
+{
+    const unsigned long ticket = m_next_ticket++;
+
+    Region region;
+    region.ticket = ticket;
+    region.position = position;
+    region.size = size;
+
+    // Nothing to read, but the ticket is still returned by poll
+    const bool empty = !clip(region.position, region.size);
+    if(empty)
+        region.size = {0, 0};
+
+    if(!m_async)
+    {
+        if(!empty)
+            read_pixels(region);
+
+        m_ready.push_back(std::move(region));
+        return ticket;
+    }
+
+    // Every buffer is still being read, the oldest
+    // one is copied even if it has to wait for it
+    if(m_count == BUFFERS)
+        complete();
+
+    Slot& slot = m_slots[(m_first + m_count) % BUFFERS];
+    m_count++;
+
+    // The slot is only keeping the order of the tickets,
+    // so it's not returned before the older regions
+    if(empty)
+    {
+        slot.region = std::move(region);
+        return ticket;
+    }
+
+    const size_t bytes = static_cast<size_t>(region.size.width) * region.size.height * sizeof(Color);
+
+    m_gl.bind_buffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if(bytes > slot.capacity)
+    {
+        m_gl.buffer_data(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        slot.capacity = bytes;
+    }
+
+    // With a pixel buffer bound, glReadPixels is only
+    // starting the copy and returns right away
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(
+        region.position.x, m_renderer.get_geometry().height - region.position.y - region.size.height,
+        region.size.width, region.size.height,
+        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_gl.bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if(m_gl.fences())
+        slot.fence = m_gl.fence_sync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    slot.region = std::move(region);
+    return ticket;
+}
+
+bool PixelReader::poll(Region& region)
+{
+    if(m_ready.empty() && m_count > 0 && is_ready(m_slots[m_first]))
+        complete();
+
+    if(m_ready.empty())
+        return false;
+
+    region = std::move(m_ready.front());
+    m_ready.pop_front();
+    return true;
+}
+
+bool PixelReader::wait(Region& region)
+{
+    if(m_ready.empty() && m_count > 0)
+        complete();
+
+    return poll(region);
+}
+
+size_t PixelReader::get_pending() const {
+    return m_ready.size() + m_count;
+}
+
+// ------------------------------------------------------------ //
+
+void PixelReader::read(const std::vector<VectorUI>& points, std::vector<Color>& colors)
+{
+    colors.assign(points.size(), Color(0, 0, 0));
+
+    const Geometry& window = m_renderer.get_geometry();
+
+    // The rectangle around every point inside of the window
+    VectorUI min(window.width, window.height);
+    VectorUI max(0, 0);
+    for(const auto& point : points)
+    {
+        if(point.x >= window.width || point.y >= window.height)
+            continue;
+
+        min.x = std::min(min.x, point.x);
+        min.y = std::min(min.y, point.y);
+        max.x = std::max(max.x, point.x + 1);
+        max.y = std::max(max.y, point.y + 1);
+    }
+
+    if(min.x >= max.x || min.y >= max.y)
+        return;
+
+    Region region;
+    region.position = min;
+    region.size = {max.x - min.x, max.y - min.y};
+    read_pixels(region);
+
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        const VectorUI& point = points[i];
+        if(point.x < window.width && point.y < window.height)
+            colors[i] = region.get_pixel(point.x - min.x, point.y - min.y);
+    }
+}
+
+// ------------------------------------------------------------ //
+
+bool PixelReader::clip(VectorUI& position, Geometry& size) const
+{
+    const Geometry& window = m_renderer.get_geometry();
+    if(position.x >= window.width || position.y >= window.height)
+        return false;
+
+    size.width  = std::min(size.width,  window.width  - position.x);
+    size.height = std::min(size.height, window.height - position.y);
+
+    return size.width > 0 && size.height > 0;
+}
+
+void PixelReader::read_pixels(Region& region) const
+{
+    const size_t pixels = static_cast<size_t>(region.size.width) * region.size.height;
+    region.pixels.resize(pixels);
+
+    // The last frame that was drawn by the software rasterizer
+    if(const SoftwareRasterizer* rasterizer = m_renderer.get_rasterizer())
+    {
+        const unsigned int width = rasterizer->get_size().width;
+        for(unsigned int y = 0; y < region.size.height; y++)
+        {
+            const Color* row = rasterizer->get_pixels() + (region.position.y + y) * width + region.position.x;
+            std::copy(row, row + region.size.width, &region.pixels[y * region.size.width]);
+        }
+        return;
+    }
+
+    std::vector<Color> flipped(pixels);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(
+        region.position.x, m_renderer.get_geometry().height - region.position.y - region.size.height,
+        region.size.width, region.size.height,
+        GL_RGBA, GL_UNSIGNED_BYTE, flipped.data());
+
+    // OpenGL starts from the bottom row
+    for(unsigned int y = 0; y < region.size.height; y++)
+    {
+        const Color* row = &flipped[(region.size.height - y - 1) * region.size.width];
+        std::copy(row, row + region.size.width, &region.pixels[y * region.size.width]);
+    }
+}
+
+bool PixelReader::is_ready(const Slot& slot) const
+{
+    // Nothing was read into it
+    if(slot.region.size.width == 0)
+        return true;
+
+    // Without fences, a buffer is assumed to be
+    // done when every other buffer was requested after it
+    if(!slot.fence)
+        return m_next_ticket - slot.region.ticket >= BUFFERS - 1;
+
+    const GLenum status = m_gl.client_wait_sync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+void PixelReader::complete()
+{
+    Slot& slot = m_slots[m_first];
+    m_first = (m_first + 1) % BUFFERS;
+    m_count--;
+
+    if(slot.fence)
+    {
+        m_gl.delete_sync(slot.fence);
+        slot.fence = nullptr;
+    }
+
+    Region region = std::move(slot.region);
+    if(region.size.width == 0)
+    {
+        m_ready.push_back(std::move(region));
+        return;
+    }
+
+    const size_t pixels = static_cast<size_t>(region.size.width) * region.size.height;
+    region.pixels.resize(pixels);
+
+    m_gl.bind_buffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const Color* mapped = static_cast<const Color*>(m_gl.map_buffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+    // OpenGL starts from the bottom row
+    if(mapped)
+    {
+        for(unsigned int y = 0; y < region.size.height; y++)
+        {
+            const Color* row = mapped + (region.size.height - y - 1) * region.size.width;
+            std::copy(row, row + region.size.width, &region.pixels[y * region.size.width]);
+        }
+        m_gl.unmap_buffer(GL_PIXEL_PACK_BUFFER);
+    }
+    m_gl.bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_ready.push_back(std::move(region));
+}
+
+END_NAMESPACE
@@ -0,0 +1,193 @@
+#include "../include/profiler.hpp"
+#include "../include/utils/ring_buffer.hpp"
+#include "../include/utils/aligned.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <fstream>
+
+START_NAMESPACE
+
+// Only this file can see it
+namespace {
+
+// The zones of a single thread, the thread is the only
+// producer and collect is the only consumer
+struct ThreadZones
+{
+    RingBuffer<Profiler::Zone, Profiler::ZONES_PER_THREAD> zones;
+    uint32_t id;
+    std::string name;
+}; // ThreadZones
+
+// The ring buffer is aligned to a cache line
+using ThreadZonesPtr = std::unique_ptr<ThreadZones, AlignedDeleter<ThreadZones>>;
+
+// Every thread that recorded a zone, they are kept after the
+// thread is gone so its zones can still be collected
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadZonesPtr> threads;
+    std::vector<Profiler::Record> records;
+}; // Registry
+
+} // namespace
+
+static Registry& registry()
+{
+    static Registry registry_;
+    return registry_;
+}
+
+static std::atomic<bool> enabled(true);
+static std::atomic<size_t> dropped(0);
+static thread_local ThreadZones* local_zones = nullptr;
+
+static ThreadZones& thread_zones()
+{
+    if(local_zones)
+        return *local_zones;
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    ThreadZonesPtr zones(aligned_new<ThreadZones>());
+    zones->id = static_cast<uint32_t>(r.threads.size());
+    zones->name = "thread " + std::to_string(zones->id);
+
+    local_zones = zones.get();
+    r.threads.push_back(std::move(zones));
+    return *local_zones;
+}
+
+// Quotes and backslashes cannot be inside of a JSON string
+static void write_string(std::ostream& stream, const std::string& text)
+{
+    stream << '"';
+    for(char c : text)
+    {
+        if(c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if(static_cast<unsigned char>(c) >= 0x20)
+            stream << c;
+    }
+    stream << '"';
+}
+
+// ------------------------------------------------------------ //
+
+void Profiler::set_enabled(bool enabled_) {
+    enabled.store(enabled_, std::memory_order_relaxed);
+}
+
+bool Profiler::is_enabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------ //
+
+uint64_t Profiler::now()
+{
+    using namespace std::chrono;
+
+    static const steady_clock::time_point start = steady_clock::now();
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+}
+
+void Profiler::record(const char* name, uint64_t begin, uint64_t end)
+{
+    if(!thread_zones().zones.push({ name, begin, end }))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::set_thread_name(const std::string& name)
+{
+    ThreadZones& zones = thread_zones();
+
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    zones.name = name;
+}
+
+// ------------------------------------------------------------ //
+
+size_t Profiler::collect()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    const size_t before = r.records.size();
+    for(auto& thread : r.threads)
+    {
+        Zone zone;
+        while(thread->zones.pop(zone))
+            r.records.push_back({ zone, thread->id });
+    }
+
+    return r.records.size() - before;
+}
+
+const std::vector<Profiler::Record>& Profiler::get_records() {
+    return registry().records;
+}
+
+void Profiler::clear()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.records.clear();
+}
+
+size_t Profiler::get_dropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------ //
+
+void Profiler::write_chrome_trace(std::ostream& stream)
+{
+    collect();
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // The names of the threads first
+    bool first = true;
+    for(const auto& thread : r.threads)
+    {
+        stream << (first ? "" : ",") << "\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id
+               << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        write_string(stream, thread->name);
+        stream << "}}";
+        first = false;
+    }
+
+    // Complete events, the times of the trace are in microseconds
+    for(const auto& record : r.records)
+    {
+        stream << (first ? "" : ",") << "\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << record.thread << ",\"name\":";
+        write_string(stream, record.zone.name);
+        stream << ",\"ts\":" << record.zone.begin / 1000 << '.' << (record.zone.begin % 1000) / 100
+               << ",\"dur\":" << (record.zone.end - record.zone.begin) / 1000 << '.'
+               << ((record.zone.end - record.zone.begin) % 1000) / 100 << '}';
+        first = false;
+    }
+
+    stream << "\n]}\n";
+}
+
+bool Profiler::write_chrome_trace(const std::string& path)
+{
+    std::ofstream file(path);
+    if(!file)
+        return false;
+
+    write_chrome_trace(file);
+    return static_cast<bool>(file);
+}
+
+END_NAMESPACE
@@ -0,0 +1,126 @@
+#include "../include/share_group.hpp"
+#include "../include/texture_cache.hpp"
+
+#include <map>
+#include <algorithm>
+
+START_NAMESPACE
+
+// Only this file can see it
+namespace {
+
+// The group of every context that joined one
+struct Registry
+{
+    std::mutex mutex;
+    std::map<void*, ShareGroup*> groups;
+}; // Registry
+
+} // namespace
+
+static Registry& registry()
+{
+    static Registry registry_;
+    return registry_;
+}
+
+// ------------------------------------------------------------ //
+
+ShareGroup::ShareGroup()
+    : m_api(Api::GLX), m_key(nullptr) {}
+
+ShareGroup::~ShareGroup()
+{
+    // Windows that are still alive are not sharing anymore
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for(void* context : m_contexts)
+        registry().groups.erase(context);
+}
+
+// ------------------------------------------------------------ //
+
+size_t ShareGroup::get_window_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_contexts.size();
+}
+
+// ------------------------------------------------------------ //
+
+void* ShareGroup::key_of(void* context)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    auto found = r.groups.find(context);
+    return found != r.groups.end() ? found->second->m_key : context;
+}
+
+bool ShareGroup::is_shared(void* context)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.groups.count(context) > 0;
+}
+
+// ------------------------------------------------------------ //
+
+bool ShareGroup::begin_join(Api api, void*& share)
+{
+    m_mutex.lock();
+
+    share = nullptr;
+    if(m_contexts.empty())
+    {
+        m_api = api;
+        return true;
+    }
+
+    // A context of another API is created on its own
+    if(m_api != api)
+        return false;
+
+    share = m_contexts.front();
+    return true;
+}
+
+void ShareGroup::end_join(void* context)
+{
+    if(context)
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+
+        if(m_contexts.empty())
+            m_key = context;
+
+        m_contexts.push_back(context);
+        registry().groups[context] = this;
+    }
+
+    m_mutex.unlock();
+}
+
+void ShareGroup::leave(void* context)
+{
+    // A context that couldn't join has its own textures
+    void* dropped = context;
+    {
+        std::lock_guard<std::mutex> group(m_mutex);
+        std::lock_guard<std::mutex> lock(registry().mutex);
+
+        auto found = std::find(m_contexts.begin(), m_contexts.end(), context);
+        if(found != m_contexts.end())
+        {
+            m_contexts.erase(found);
+            registry().groups.erase(context);
+
+            // The textures of the group are gone with its last context
+            dropped = m_contexts.empty() ? m_key : nullptr;
+        }
+    }
+
+    // The cache is locking the registry too
+    TextureCache::drop_context(dropped);
+}
+
+END_NAMESPACE
@@ -0,0 +1,614 @@
+#include "../include/software_rasterizer.hpp"
+#include "../include/profiler.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define GFX_RASTER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define GFX_RASTER_NEON
+#endif
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+START_NAMESPACE
+
+// Vertices are snapped to 1/256 of a pixel, exactly
+// like the sub pixel precision of most GPUs
+static constexpr int64_t SUBPIXEL_BITS = 8;
+static constexpr int64_t SUBPIXEL = 1 << SUBPIXEL_BITS;
+
+// Anything further away is clamped, so the edge
+// functions can never overflow
+static constexpr float GUARD_BAND = 32768.f;
+
+// Only this file can see it
+namespace {
+
+// Every texture of every software window
+struct Textures
+{
+    std::mutex mutex;
+    std::map<unsigned int, std::shared_ptr<SoftwareRasterizer::Texture>> textures;
+    unsigned int next_id = 1;
+}; // Textures
+
+} // namespace
+
+static Textures& textures()
+{
+    static Textures textures_;
+    return textures_;
+}
+
+static thread_local SoftwareRasterizer* current_rasterizer = nullptr;
+
+// ------------------------------------------------------------ //
+
+// Writing the same color into a row of pixels, four at a time
+static void fill_span(Color* out, size_t count, const Color& color)
+{
+    size_t i = 0;
+
+#if defined(GFX_RASTER_SSE2) || defined(GFX_RASTER_NEON)
+    uint32_t packed;
+    std::memcpy(&packed, &color, sizeof(packed));
+#endif
+
+#if defined(GFX_RASTER_SSE2)
+    const __m128i value = _mm_set1_epi32(static_cast<int>(packed));
+    for(; i + 4 <= count; i += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+#elif defined(GFX_RASTER_NEON)
+    const uint32x4_t value = vdupq_n_u32(packed);
+    for(; i + 4 <= count; i += 4)
+        vst1q_u32(reinterpret_cast<uint32_t*>(out + i), value);
+#endif
+
+    for(; i < count; i++)
+        out[i] = color;
+}
+
+// Rounding towards negative infinity, the
+// numerator can be negative
+static int64_t floor_div(int64_t numerator, int64_t denominator)
+{
+    int64_t result = numerator / denominator;
+    if((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0)))
+        result--;
+    return result;
+}
+
+static int64_t ceil_div(int64_t numerator, int64_t denominator) {
+    return -floor_div(-numerator, denominator);
+}
+
+static int64_t to_fixed(float value)
+{
+    value = std::min(std::max(value, -GUARD_BAND), GUARD_BAND);
+    return static_cast<int64_t>(std::lround(value * SUBPIXEL));
+}
+
+static unsigned char to_channel(float value)
+{
+    const int rounded = static_cast<int>(value + 0.5f);
+    return static_cast<unsigned char>(rounded < 0 ? 0 : (rounded > 255 ? 255 : rounded));
+}
+
+// Multiplying two normalized bytes, like GL_MODULATE
+static unsigned char modulate(unsigned char lhs, unsigned char rhs) {
+    return static_cast<unsigned char>((lhs * rhs + 127) / 255);
+}
+
+// Linear filtering, the texture coordinates are
+// between 0 and 1 exactly like OpenGL
+static Color sample(const SoftwareRasterizer::Texture& texture, float u, float v)
+{
+    const int width  = static_cast<int>(texture.size.width);
+    const int height = static_cast<int>(texture.size.height);
+
+    const float x = u * width  - 0.5f;
+    const float y = v * height - 0.5f;
+    const float fx = std::floor(x);
+    const float fy = std::floor(y);
+    const float tx = x - fx;
+    const float ty = y - fy;
+
+    auto wrap = [&texture](int coordinate, int size) {
+        if(texture.repeat)
+        {
+            coordinate %= size;
+            return coordinate < 0 ? coordinate + size : coordinate;
+        }
+        return coordinate < 0 ? 0 : (coordinate >= size ? size - 1 : coordinate);
+    };
+
+    const int x0 = wrap(static_cast<int>(fx), width);
+    const int x1 = wrap(static_cast<int>(fx) + 1, width);
+    const int y0 = wrap(static_cast<int>(fy), height);
+    const int y1 = wrap(static_cast<int>(fy) + 1, height);
+
+    const Color& c00 = texture.pixels[y0 * width + x0];
+    const Color& c10 = texture.pixels[y0 * width + x1];
+    const Color& c01 = texture.pixels[y1 * width + x0];
+    const Color& c11 = texture.pixels[y1 * width + x1];
+
+    auto mix = [tx, ty](unsigned char a, unsigned char b, unsigned char c, unsigned char d) {
+        const float top    = a + (b - a) * tx;
+        const float bottom = c + (d - c) * tx;
+        return to_channel(top + (bottom - top) * ty);
+    };
+
+    Color result;
+    result.r = mix(c00.r, c10.r, c01.r, c11.r);
+    result.g = mix(c00.g, c10.g, c01.g, c11.g);
+    result.b = mix(c00.b, c10.b, c01.b, c11.b);
+    result.a = mix(c00.a, c10.a, c01.a, c11.a);
+    return result;
+}
+
+// ------------------------------------------------------------ //
+
+SoftwareRasterizer::SoftwareRasterizer(const Geometry& size)
+    : SoftwareRasterizer(size, ThreadPool::hardware_workers() - 1) {}
+
+SoftwareRasterizer::SoftwareRasterizer(const Geometry& size, size_t workers)
+    : m_size(size),
+      m_pixels(static_cast<size_t>(size.width) * size.height, Color(0, 0, 0)),
+      m_tiles_x((static_cast<int>(size.width)  + TILE_SIZE - 1) / TILE_SIZE),
+      m_tiles_y((static_cast<int>(size.height) + TILE_SIZE - 1) / TILE_SIZE)
+{
+    if(workers > 0)
+        m_pool.reset(new ThreadPool(workers));
+
+    m_bins.resize(static_cast<size_t>(m_tiles_x) * m_tiles_y);
+}
+
+// ------------------------------------------------------------ //
+
+SoftwareRasterizer* SoftwareRasterizer::current() {
+    return current_rasterizer;
+}
+
+void SoftwareRasterizer::make_current(SoftwareRasterizer* rasterizer) {
+    current_rasterizer = rasterizer;
+}
+
+// ------------------------------------------------------------ //
+
+void SoftwareRasterizer::clear(const Color& color) {
+    fill_span(m_pixels.data(), m_pixels.size(), color);
+}
+
+void SoftwareRasterizer::draw(const Batch& batch)
+{
+    GFX_PROFILE_ZONE("rasterize");
+
+    m_primitives.clear();
+    m_textures.clear();
+    for(auto& tile : m_bins)
+        tile.clear();
+
+    for(const auto& command : batch.m_commands)
+    {
+        // Holding the texture until the frame is drawn, so it's
+        // never deleted or replaced while the tiles are reading it
+        const Texture* texture = nullptr;
+        if(command.texture != 0)
+        {
+            Textures& t = textures();
+            std::lock_guard<std::mutex> lock(t.mutex);
+
+            auto found = t.textures.find(command.texture);
+            if(found != t.textures.end())
+            {
+                m_textures.push_back(found->second);
+                texture = found->second.get();
+            }
+        }
+
+        const bool line = command.primitive == Batch::Primitive::Lines;
+        const size_t step = line ? 2 : 3;
+
+        for(size_t i = 0; i + step <= command.count; i += step)
+        {
+            const BatchVertex* vertices = &batch.m_vertices[command.first + i];
+
+            float min_x = vertices[0].x, max_x = vertices[0].x;
+            float min_y = vertices[0].y, max_y = vertices[0].y;
+            for(size_t j = 1; j < step; j++)
+            {
+                min_x = std::min(min_x, vertices[j].x);
+                max_x = std::max(max_x, vertices[j].x);
+                min_y = std::min(min_y, vertices[j].y);
+                max_y = std::max(max_y, vertices[j].y);
+            }
+
+            min_x = std::max(min_x, -GUARD_BAND);
+            min_y = std::max(min_y, -GUARD_BAND);
+            max_x = std::min(max_x, GUARD_BAND);
+            max_y = std::min(max_y, GUARD_BAND);
+
+            // Lines are touching the pixels around them
+            const int extra = line ? 1 : 0;
+            const Bounds bounds = {
+                std::max(static_cast<int>(std::floor(min_x)) - extra, 0),
+                std::max(static_cast<int>(std::floor(min_y)) - extra, 0),
+                std::min(static_cast<int>(std::ceil(max_x)) + extra + 1, static_cast<int>(m_size.width)),
+                std::min(static_cast<int>(std::ceil(max_y)) + extra + 1, static_cast<int>(m_size.height))
+            };
+
+            if(bounds.left >= bounds.right || bounds.top >= bounds.bottom)
+                continue;
+
+            m_primitives.push_back({ vertices, texture, line });
+            bin(static_cast<uint32_t>(m_primitives.size() - 1), bounds);
+        }
+    }
+
+    if(m_primitives.empty())
+        return;
+
+    // Every thread is taking the next tile until there are
+    // no more tiles, the calling thread is drawing as well
+    std::atomic<size_t> next(0);
+    auto work = [this, &next]() {
+        size_t tile;
+        while((tile = next++) < m_bins.size())
+            draw_tile(tile);
+    };
+
+    std::vector<std::future<void>> workers;
+    if(m_pool)
+    {
+        for(size_t i = 0; i < m_pool->get_worker_count(); i++)
+            workers.push_back(m_pool->submit(work));
+    }
+
+    work();
+    for(auto& worker : workers)
+        worker.get();
+}
+
+// ------------------------------------------------------------ //
+
+const Geometry& SoftwareRasterizer::get_size() const {
+    return m_size;
+}
+
+size_t SoftwareRasterizer::get_worker_count() const {
+    return m_pool ? m_pool->get_worker_count() : 0;
+}
+
+const Color* SoftwareRasterizer::get_pixels() const {
+    return m_pixels.data();
+}
+
+Color SoftwareRasterizer::get_pixel(unsigned int x, unsigned int y) const
+{
+    if(x >= m_size.width || y >= m_size.height)
+        return Color(0, 0, 0);
+
+    return m_pixels[y * m_size.width + x];
+}
+
+// ------------------------------------------------------------ //
+
+unsigned int SoftwareRasterizer::create_texture(unsigned int width, unsigned int height, const Color* pixels, bool repeat)
+{
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+    texture->size = {width, height};
+    texture->repeat = repeat;
+
+    if(pixels)
+        texture->pixels.assign(pixels, pixels + static_cast<size_t>(width) * height);
+    else
+        texture->pixels.assign(static_cast<size_t>(width) * height, Color(0, 0, 0, 0));
+
+    Textures& t = textures();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    const unsigned int id = t.next_id++;
+    t.textures[id] = texture;
+    return id;
+}
+
+void SoftwareRasterizer::update_texture(unsigned int id, unsigned int x, unsigned int y,
+                                        unsigned int width, unsigned int height,
+                                        const Color* pixels, unsigned int row_length)
+{
+    Textures& t = textures();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    auto found = t.textures.find(id);
+    if(found == t.textures.end())
+        return;
+
+    // A window is drawing with the texture right now, so
+    // it's keeping the old pixels and the next frame is
+    // going to use the new ones
+    if(found->second.use_count() > 1)
+        found->second = std::make_shared<Texture>(*found->second);
+
+    Texture& texture = *found->second;
+    if(x >= texture.size.width || y >= texture.size.height)
+        return;
+
+    width  = std::min(width,  texture.size.width  - x);
+    height = std::min(height, texture.size.height - y);
+
+    for(unsigned int row = 0; row < height; row++)
+    {
+        const Color* from = pixels + static_cast<size_t>(row) * row_length;
+        std::copy(from, from + width, &texture.pixels[(y + row) * texture.size.width + x]);
+    }
+}
+
+bool SoftwareRasterizer::read_texture(unsigned int id, Texture& texture)
+{
+    Textures& t = textures();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    auto found = t.textures.find(id);
+    if(found == t.textures.end())
+        return false;
+
+    texture = *found->second;
+    return true;
+}
+
+void SoftwareRasterizer::delete_texture(unsigned int id)
+{
+    Textures& t = textures();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    t.textures.erase(id);
+}
+
+// ------------------------------------------------------------ //
+
+void SoftwareRasterizer::bin(uint32_t index, const Bounds& bounds)
+{
+    const int first_x = bounds.left / TILE_SIZE;
+    const int first_y = bounds.top / TILE_SIZE;
+    const int last_x  = (bounds.right - 1) / TILE_SIZE;
+    const int last_y  = (bounds.bottom - 1) / TILE_SIZE;
+
+    for(int y = first_y; y <= last_y; y++)
+    {
+        for(int x = first_x; x <= last_x; x++)
+            m_bins[y * m_tiles_x + x].push_back(index);
+    }
+}
+
+void SoftwareRasterizer::draw_tile(size_t tile)
+{
+    GFX_PROFILE_ZONE("rasterize tile");
+
+    const int x = static_cast<int>(tile % m_tiles_x) * TILE_SIZE;
+    const int y = static_cast<int>(tile / m_tiles_x) * TILE_SIZE;
+
+    const Bounds bounds = {
+        x, y,
+        std::min(x + TILE_SIZE, static_cast<int>(m_size.width)),
+        std::min(y + TILE_SIZE, static_cast<int>(m_size.height))
+    };
+
+    for(uint32_t index : m_bins[tile])
+    {
+        const Primitive& primitive = m_primitives[index];
+        if(primitive.line)
+            draw_line(primitive, bounds);
+        else
+            draw_triangle(primitive, bounds);
+    }
+}
+
+// ------------------------------------------------------------ //
+
+void SoftwareRasterizer::draw_triangle(const Primitive& primitive, const Bounds& tile)
+{
+    const BatchVertex* v[3] = { &primitive.vertices[0], &primitive.vertices[1], &primitive.vertices[2] };
+    int64_t x[3], y[3];
+    for(int i = 0; i < 3; i++)
+    {
+        x[i] = to_fixed(v[i]->x);
+        y[i] = to_fixed(v[i]->y);
+    }
+
+    int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if(area == 0)
+        return;
+
+    // Triangles are never culled, so both of the
+    // windings are turned into the same one
+    if(area < 0)
+    {
+        std::swap(v[1], v[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        area = -area;
+    }
+
+    // The edge in front of every vertex as a function of the pixel:
+    // E(px, py) = a * px + b * py + c, it's positive inside of the
+    // triangle and it's evaluated at the center of the pixel
+    int64_t a[3], b[3], c[3];
+    for(int i = 0; i < 3; i++)
+    {
+        const int from = (i + 1) % 3;
+        const int to   = (i + 2) % 3;
+        const int64_t dx = x[to] - x[from];
+        const int64_t dy = y[to] - y[from];
+
+        a[i] = -dy * SUBPIXEL;
+        b[i] =  dx * SUBPIXEL;
+        c[i] = dx * (SUBPIXEL / 2 - y[from]) - dy * (SUBPIXEL / 2 - x[from]);
+
+        // Top left rule, pixels that are exactly on a shared
+        // edge are only drawn by one of the triangles
+        const bool top_left = (dy == 0 && dx > 0) || dy < 0;
+        if(!top_left)
+            c[i] -= 1;
+    }
+
+    const int64_t min_y = std::min(std::min(y[0], y[1]), y[2]);
+    const int64_t max_y = std::max(std::max(y[0], y[1]), y[2]);
+    const int top    = std::max(tile.top,    static_cast<int>(floor_div(min_y, SUBPIXEL)));
+    const int bottom = std::min(tile.bottom, static_cast<int>(floor_div(max_y, SUBPIXEL)) + 1);
+
+    const bool flat = !primitive.texture &&
+        std::memcmp(&v[0]->color, &v[1]->color, sizeof(Color)) == 0 &&
+        std::memcmp(&v[0]->color, &v[2]->color, sizeof(Color)) == 0;
+
+    const float inverse_area = 1.f / static_cast<float>(area);
+
+    for(int py = top; py < bottom; py++)
+    {
+        // The pixels of this row that are inside of every edge
+        int64_t left  = tile.left;
+        int64_t right = tile.right;
+        int64_t k[3];
+
+        for(int i = 0; i < 3; i++)
+        {
+            k[i] = b[i] * py + c[i];
+
+            if(a[i] > 0)
+                left = std::max(left, ceil_div(-k[i], a[i]));
+            else if(a[i] < 0)
+                right = std::min(right, floor_div(k[i], -a[i]) + 1);
+            else if(k[i] < 0)
+                right = left;
+        }
+
+        if(left >= right)
+            continue;
+
+        Color* row = &m_pixels[static_cast<size_t>(py) * m_size.width];
+
+        if(flat)
+        {
+            fill_span(row + left, static_cast<size_t>(right - left), v[0]->color);
+            continue;
+        }
+
+        // The weights of the vertices at the first pixel,
+        // and how much they change on every pixel
+        float weight[3], step[3];
+        for(int i = 0; i < 3; i++)
+        {
+            weight[i] = static_cast<float>(a[i] * left + k[i]) * inverse_area;
+            step[i]   = static_cast<float>(a[i]) * inverse_area;
+        }
+
+        for(int64_t px = left; px < right; px++)
+        {
+            Color color;
+            color.r = to_channel(weight[0] * v[0]->color.r + weight[1] * v[1]->color.r + weight[2] * v[2]->color.r);
+            color.g = to_channel(weight[0] * v[0]->color.g + weight[1] * v[1]->color.g + weight[2] * v[2]->color.g);
+            color.b = to_channel(weight[0] * v[0]->color.b + weight[1] * v[1]->color.b + weight[2] * v[2]->color.b);
+            color.a = to_channel(weight[0] * v[0]->color.a + weight[1] * v[1]->color.a + weight[2] * v[2]->color.a);
+
+            if(primitive.texture)
+            {
+                const float u  = weight[0] * v[0]->u + weight[1] * v[1]->u + weight[2] * v[2]->u;
+                const float tv = weight[0] * v[0]->v + weight[1] * v[1]->v + weight[2] * v[2]->v;
+                const Color texel = sample(*primitive.texture, u, tv);
+
+                color.r = modulate(color.r, texel.r);
+                color.g = modulate(color.g, texel.g);
+                color.b = modulate(color.b, texel.b);
+                color.a = modulate(color.a, texel.a);
+            }
+
+            row[px] = color;
+
+            for(int i = 0; i < 3; i++)
+                weight[i] += step[i];
+        }
+    }
+}
+
+void SoftwareRasterizer::draw_line(const Primitive& primitive, const Bounds& tile)
+{
+    const BatchVertex& from = primitive.vertices[0];
+    const BatchVertex& to   = primitive.vertices[1];
+
+    // Lines are stepped in the coordinates of OpenGL, where the
+    // first row is at the bottom, so the pixels that are exactly
+    // between two pixels are chosen the same way
+    const float height = static_cast<float>(m_size.height);
+    const float from_y = height - from.y;
+    const float to_y   = height - to.y;
+
+    const float dx = to.x - from.x;
+    const float dy = to_y - from_y;
+    if(dx == 0.f && dy == 0.f)
+        return;
+
+    // Stepping one pixel at a time along the longer axis
+    const bool along_x = std::fabs(dx) >= std::fabs(dy);
+    const float major_from = along_x ? from.x : from_y;
+    const float major_to   = along_x ? to.x   : to_y;
+    const float minor_from = along_x ? from_y : from.x;
+    const float minor_to   = along_x ? to_y   : to.x;
+
+    // The pixels whose centers are between the two ends,
+    // the last pixel is not drawn exactly like OpenGL
+    int first, last;
+    if(major_to > major_from)
+    {
+        first = static_cast<int>(std::ceil(major_from - 0.5f));
+        last  = static_cast<int>(std::ceil(major_to - 0.5f)) - 1;
+    }
+    else
+    {
+        first = static_cast<int>(std::floor(major_to - 0.5f)) + 1;
+        last  = static_cast<int>(std::floor(major_from - 0.5f));
+    }
+
+    // The tile in the coordinates of OpenGL
+    const int rows = static_cast<int>(m_size.height);
+    const Bounds flipped = { tile.left, rows - tile.bottom, tile.right, rows - tile.top };
+
+    // Only the part of the line inside of this tile
+    first = std::max(first, along_x ? flipped.left : flipped.top);
+    last  = std::min(last, (along_x ? flipped.right : flipped.bottom) - 1);
+
+    const int minor_begin = along_x ? flipped.top : flipped.left;
+    const int minor_end   = along_x ? flipped.bottom : flipped.right;
+
+    const bool flat = std::memcmp(&from.color, &to.color, sizeof(Color)) == 0;
+    const float length = major_to - major_from;
+
+    for(int i = first; i <= last; i++)
+    {
+        const float t = (i + 0.5f - major_from) / length;
+
+        // A point on the edge of two pixels belongs to the lower one
+        const int j = static_cast<int>(std::ceil(minor_from + t * (minor_to - minor_from))) - 1;
+        if(j < minor_begin || j >= minor_end)
+            continue;
+
+        Color color = from.color;
+        if(!flat)
+        {
+            color.r = to_channel(from.color.r + (to.color.r - from.color.r) * t);
+            color.g = to_channel(from.color.g + (to.color.g - from.color.g) * t);
+            color.b = to_channel(from.color.b + (to.color.b - from.color.b) * t);
+            color.a = to_channel(from.color.a + (to.color.a - from.color.a) * t);
+        }
+
+        const int px = along_x ? i : j;
+        const int py = rows - 1 - (along_x ? j : i);
+        m_pixels[static_cast<size_t>(py) * m_size.width + px] = color;
+    }
+}
+
+END_NAMESPACE
@@ -0,0 +1,261 @@
+#include "../include/texture_atlas.hpp"
+#include "../include/software_rasterizer.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/gl.h>
+#elif __linux__
+#include <GL/gl.h>
+#endif
+
+#include "../external_libs/stb_image.h"
+
+#include <stdexcept>
+#include <limits>
+
+START_NAMESPACE
+
+// Every image is surrounded by a copy of its edges, so linear
+// filtering never reads the pixels of the image next to it
+static constexpr unsigned int PADDING = 1;
+
+// ------------------------------------------------------------ //
+
+TextureAtlas::TextureAtlas(unsigned int width, unsigned int height)
+    : m_page_size(width, height) {}
+
+TextureAtlas::~TextureAtlas()
+{
+    for(auto& page : m_pages)
+    {
+        if(SoftwareRasterizer::current())
+            SoftwareRasterizer::delete_texture(page.texture);
+        else
+            glDeleteTextures(1, &page.texture);
+    }
+}
+
+// ------------------------------------------------------------ //
+
+TextureAtlas::Region TextureAtlas::add(const std::string& path)
+{
+    int width = 0;
+    int height = 0;
+    int nr_channels;
+
+    // Always 4 channels, so every page is RGBA
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nr_channels, 4);
+    if(!data)
+        throw std::logic_error("Failed to load texture!");
+
+    Region region;
+    try {
+        region = add(data, width, height);
+    }
+    catch(...) {
+        stbi_image_free(data);
+        throw;
+    }
+
+    stbi_image_free(data);
+    return region;
+}
+
+TextureAtlas::Region TextureAtlas::add(const unsigned char* pixels, unsigned int width, unsigned int height)
+{
+    const unsigned int padded_width  = width  + PADDING * 2;
+    const unsigned int padded_height = height + PADDING * 2;
+
+    if(padded_width > m_page_size.width || padded_height > m_page_size.height)
+        throw std::logic_error("Image is bigger than the atlas page!");
+
+    // The first page that has room for it
+    Page* page = nullptr;
+    size_t index = 0;
+    VectorUI position;
+
+    for(auto& p : m_pages)
+    {
+        if(find(p, padded_width, padded_height, index, position))
+        {
+            page = &p;
+            break;
+        }
+    }
+
+    if(page == nullptr)
+    {
+        page = &create_page();
+        find(*page, padded_width, padded_height, index, position);
+    }
+
+    place(*page, index, position, padded_width, padded_height);
+
+    // Copying the image with its edges repeated into the padding
+    std::vector<unsigned char> padded(padded_width * padded_height * 4);
+    for(unsigned int y = 0; y < padded_height; y++)
+    {
+        const unsigned int src_y = y < PADDING ? 0 : (y - PADDING >= height ? height - 1 : y - PADDING);
+        for(unsigned int x = 0; x < padded_width; x++)
+        {
+            const unsigned int src_x = x < PADDING ? 0 : (x - PADDING >= width ? width - 1 : x - PADDING);
+            const unsigned char* src = pixels + (src_y * width + src_x) * 4;
+            unsigned char* dst = padded.data() + (y * padded_width + x) * 4;
+
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = src[3];
+        }
+    }
+
+    if(SoftwareRasterizer::current())
+    {
+        SoftwareRasterizer::update_texture(page->texture, position.x, position.y, padded_width, padded_height, 
+            reinterpret_cast<const Color*>(padded.data()), padded_width);
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, page->texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, padded_width, padded_height, 
+            GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    Region region;
+    region.texture  = page->texture;
+    region.position = { position.x + PADDING, position.y + PADDING };
+    region.size     = { width, height };
+    region.uv_min   = {
+        static_cast<float>(region.position.x) / m_page_size.width,
+        static_cast<float>(region.position.y) / m_page_size.height 
+    };
+    region.uv_max   = {
+        static_cast<float>(region.position.x + width)  / m_page_size.width,
+        static_cast<float>(region.position.y + height) / m_page_size.height 
+    };
+
+    return region;
+}
+
+// ------------------------------------------------------------ //
+
+size_t TextureAtlas::get_page_count() const {
+    return m_pages.size();
+}
+
+const Geometry& TextureAtlas::get_page_size() const {
+    return m_page_size;
+}
+
+// ------------------------------------------------------------ //
+
+bool TextureAtlas::find(const Page& page, unsigned int width, unsigned int height,
+                        size_t& index, VectorUI& position) const
+{
+    unsigned int best_y = std::numeric_limits<unsigned int>::max();
+    unsigned int best_width = std::numeric_limits<unsigned int>::max();
+    bool found = false;
+
+    for(size_t i = 0; i < page.skyline.size(); i++)
+    {
+        const unsigned int x = page.skyline[i].x;
+        if(x + width > m_page_size.width)
+            break;
+
+        // The rectangle is resting on the highest
+        // segment under it
+        unsigned int y = 0;
+        unsigned int covered = 0;
+        for(size_t j = i; covered < width; j++)
+        {
+            if(page.skyline[j].y > y)
+                y = page.skyline[j].y;
+            covered += page.skyline[j].width;
+        }
+
+        if(y + height > m_page_size.height)
+            continue;
+
+        // The lowest place, and the narrowest segment
+        // if there are a few of them
+        if(y < best_y || (y == best_y && page.skyline[i].width < best_width))
+        {
+            best_y = y;
+            best_width = page.skyline[i].width;
+            index = i;
+            position = { x, y };
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void TextureAtlas::place(Page& page, size_t index, const VectorUI& position,
+                         unsigned int width, unsigned int height)
+{
+    std::vector<Skyline>& skyline = page.skyline;
+
+    // The new segment on top of the rectangle
+    skyline.insert(skyline.begin() + index, { position.x, position.y + height, width });
+
+    // Cutting the segments that are under it
+    const unsigned int right = position.x + width;
+    size_t i = index + 1;
+    while(i < skyline.size() && skyline[i].x < right)
+    {
+        const unsigned int end = skyline[i].x + skyline[i].width;
+        if(end <= right)
+            skyline.erase(skyline.begin() + i);
+        else
+        {
+            skyline[i].width = end - right;
+            skyline[i].x = right;
+            break;
+        }
+    }
+
+    // Merging neighbours at the same height
+    for(i = 0; i + 1 < skyline.size();)
+    {
+        if(skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+            i++;
+    }
+}
+
+// ------------------------------------------------------------ //
+
+TextureAtlas::Page& TextureAtlas::create_page()
+{
+    Page page;
+    page.skyline.push_back({ 0, 0, m_page_size.width });
+
+    if(SoftwareRasterizer::current())
+    {
+        page.texture = SoftwareRasterizer::create_texture(m_page_size.width, m_page_size.height, nullptr, false);
+        m_pages.push_back(page);
+        return m_pages.back();
+    }
+
+    glGenTextures(1, &page.texture);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_page_size.width, m_page_size.height, 0, 
+        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_pages.push_back(page);
+    return m_pages.back();
+}
+
+END_NAMESPACE
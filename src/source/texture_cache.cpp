@@ -0,0 +1,452 @@
+#include "../include/texture_cache.hpp"
+#include "../include/software_rasterizer.hpp"
+#include "../include/share_group.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/gl.h>
+#elif __linux__
+#include <GL/gl.h>
+#include <GL/glx.h>
+#ifdef GFX_EGL
+#include <EGL/egl.h>
+#endif
+#endif
+
+#include "../external_libs/stb_image.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+
+START_NAMESPACE
+
+// The context that is current on this thread
+static void* native_context()
+{
+#ifdef _WIN32
+    return wglGetCurrentContext();
+#elif __linux__
+#ifdef GFX_EGL
+    // Headless windows are using EGL contexts
+    if(void* context = eglGetCurrentContext())
+        return context;
+#endif
+    return glXGetCurrentContext();
+#endif
+}
+
+// Textures cannot be used by other contexts, so every context
+// has its own textures unless it's in a share group
+static void* current_context() {
+    return ShareGroup::key_of(native_context());
+}
+
+// FNV-1a, it's only used to find files
+// with the same content
+static uint64_t hash_of(const std::vector<unsigned char>& bytes)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for(unsigned char byte : bytes)
+    {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// ------------------------------------------------------------ //
+
+// Only this file can see it
+namespace {
+
+struct Entry
+{
+    TextureCache::Texture texture;
+    size_t references;
+    size_t bytes;
+
+    // So the content lookup can be removed on eviction
+    bool hashed;
+    uint64_t hash;
+
+    // Created without a path, deleted by the last release
+    bool unique;
+}; // Entry
+
+struct Cache
+{
+    std::mutex mutex;
+    TextureCache::Key key = TextureCache::Key::Path;
+    size_t bytes = 0;
+
+    std::map<std::pair<void*, unsigned int>, Entry> entries;
+    std::map<std::pair<void*, std::string>, unsigned int> paths;
+    std::map<std::pair<void*, uint64_t>, unsigned int> hashes;
+}; // Cache
+
+} // namespace
+
+static Cache& cache()
+{
+    static Cache cache_;
+    return cache_;
+}
+
+// Uploading decoded RGBA pixels
+static unsigned int upload(const unsigned char* data, int width, int height)
+{
+    if(SoftwareRasterizer::current())
+        return SoftwareRasterizer::create_texture(width, height, reinterpret_cast<const Color*>(data), true);
+
+    unsigned int id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Another window of the group may be drawing it on
+    // another thread, so it has to be uploaded before that
+    if(ShareGroup::is_shared(native_context()))
+        glFinish();
+
+    return id;
+}
+
+static void destroy(unsigned int id)
+{
+    if(SoftwareRasterizer::current())
+        SoftwareRasterizer::delete_texture(id);
+    else
+        glDeleteTextures(1, &id);
+}
+
+// Everything below must be called while the cache is locked
+
+// Returns true and adds a reference if the path is cached
+static bool find_path(Cache& c, void* context, const std::string& path, TextureCache::Texture& texture)
+{
+    auto by_path = c.paths.find({context, path});
+    if(by_path == c.paths.end())
+        return false;
+
+    Entry& entry = c.entries.at({context, by_path->second});
+    entry.references++;
+    texture = entry.texture;
+    return true;
+}
+
+// Same as above for a file with the same content, the
+// next time this path is found immediately
+static bool find_hash(Cache& c, void* context, const std::string& path, uint64_t hash, TextureCache::Texture& texture)
+{
+    auto by_hash = c.hashes.find({context, hash});
+    if(by_hash == c.hashes.end())
+        return false;
+
+    Entry& entry = c.entries.at({context, by_hash->second});
+    entry.references++;
+    c.paths[{context, path}] = entry.texture.id;
+    texture = entry.texture;
+    return true;
+}
+
+// Adding an uploaded texture with a single reference
+static Entry& add_entry(Cache& c, void* context, unsigned int id, unsigned int width, unsigned int height,
+                        bool hashed, uint64_t hash, bool unique)
+{
+    Entry entry;
+    entry.texture.id = id;
+    entry.texture.size = {width, height};
+    entry.references = 1;
+    entry.bytes = static_cast<size_t>(width) * height * 4;
+    entry.hashed = hashed;
+    entry.hash = hash;
+    entry.unique = unique;
+
+    c.bytes += entry.bytes;
+    return c.entries[{context, id}] = entry;
+}
+
+// Windows of the same share group may upload the same image at the
+// same time, the first one that was inserted is kept and the other
+// one is deleted
+static TextureCache::Texture insert(Cache& c, void* context, const std::string& path, 
+                                    unsigned int id, unsigned int width, unsigned int height,
+                                    bool hashed, uint64_t hash)
+{
+    TextureCache::Texture texture;
+    if(find_path(c, context, path, texture) || (hashed && find_hash(c, context, path, hash, texture)))
+    {
+        destroy(id);
+        return texture;
+    }
+
+    add_entry(c, context, id, width, height, hashed, hash, false);
+    c.paths[{context, path}] = id;
+    if(hashed)
+        c.hashes[{context, hash}] = id;
+
+    return {id, {width, height}};
+}
+
+// ------------------------------------------------------------ //
+
+TextureCache::Texture TextureCache::acquire(const std::string& path)
+{
+    Key key;
+    {
+        std::lock_guard<std::mutex> lock(cache().mutex);
+        key = cache().key;
+    }
+
+    return acquire(path, key);
+}
+
+TextureCache::Texture TextureCache::acquire(const std::string& path, Key key)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    // Already loaded from this path
+    Texture texture;
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if(find_path(c, context, path, texture))
+            return texture;
+    }
+
+    // The file is decoded and uploaded without locking the
+    // cache, so other windows are not waiting for it
+    int width = 0;
+    int height = 0;
+    int nr_channels;
+    unsigned char* data = nullptr;
+
+    bool hashed = false;
+    uint64_t hash = 0;
+
+    if(key == Key::Content)
+    {
+        // The file is read once, and only decoded
+        // if nothing has the same content
+        std::ifstream file(path, std::ios::binary);
+        if(!file)
+            throw std::logic_error("Failed to load texture!");
+
+        std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        hashed = true;
+        hash = hash_of(bytes);
+
+        {
+            std::lock_guard<std::mutex> lock(c.mutex);
+            if(find_hash(c, context, path, hash, texture))
+                return texture;
+        }
+
+        data = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height, &nr_channels, 4);
+    }
+    else
+        data = stbi_load(path.c_str(), &width, &height, &nr_channels, 4);
+
+    if(!data)
+        throw std::logic_error("Failed to load texture!");
+
+    // Always 4 channels, the texture is uploaded as RGBA
+    const unsigned int id = upload(data, width, height);
+
+    // The pixels are already in OpenGL
+    stbi_image_free(data);
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return insert(c, context, path, id, width, height, hashed, hash);
+}
+
+TextureCache::Texture TextureCache::acquire(const std::string& path, const unsigned char* pixels, 
+                                            unsigned int width, unsigned int height)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    Texture texture;
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if(find_path(c, context, path, texture))
+            return texture;
+    }
+
+    const unsigned int id = upload(pixels, width, height);
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return insert(c, context, path, id, width, height, false, 0);
+}
+
+bool TextureCache::try_acquire(const std::string& path, Texture& texture)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return find_path(c, context, path, texture);
+}
+
+TextureCache::Texture TextureCache::create(const unsigned char* pixels, unsigned int width, unsigned int height)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    const unsigned int id = upload(pixels, width, height);
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return add_entry(c, context, id, width, height, false, 0, true).texture;
+}
+
+bool TextureCache::is_unique(unsigned int id)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    auto found = c.entries.find({context, id});
+    return found != c.entries.end() && found->second.unique && found->second.references == 1;
+}
+
+void TextureCache::set_key(Key key)
+{
+    std::lock_guard<std::mutex> lock(cache().mutex);
+    cache().key = key;
+}
+
+// ------------------------------------------------------------ //
+
+void TextureCache::retain(unsigned int id)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    auto found = c.entries.find({context, id});
+    if(found != c.entries.end())
+        found->second.references++;
+}
+
+void TextureCache::release(unsigned int id)
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    // The texture stays cached until it's evicted
+    auto found = c.entries.find({context, id});
+    if(found == c.entries.end() || found->second.references == 0)
+        return;
+
+    found->second.references--;
+
+    // Nothing can find it again
+    if(found->second.unique && found->second.references == 0)
+    {
+        destroy(id);
+        c.bytes -= found->second.bytes;
+        c.entries.erase(found);
+    }
+}
+
+// ------------------------------------------------------------ //
+
+size_t TextureCache::evict()
+{
+    Cache& c = cache();
+    void* context = current_context();
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    size_t freed = 0;
+
+    for(auto it = c.entries.begin(); it != c.entries.end();)
+    {
+        const Entry& entry = it->second;
+        if(it->first.first != context || entry.references > 0)
+        {
+            it++;
+            continue;
+        }
+
+        // Every path that was pointing to this texture
+        for(auto path = c.paths.begin(); path != c.paths.end();)
+        {
+            if(path->first.first == context && path->second == entry.texture.id)
+                path = c.paths.erase(path);
+            else
+                path++;
+        }
+        if(entry.hashed)
+            c.hashes.erase({context, entry.hash});
+
+        destroy(entry.texture.id);
+        freed += entry.bytes;
+        c.bytes -= entry.bytes;
+
+        it = c.entries.erase(it);
+    }
+
+    return freed;
+}
+
+void TextureCache::drop_context(void* context)
+{
+    // Software textures are shared by every software window
+    if(!context)
+        return;
+
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    // A new context may get the same address later, so
+    // nothing of this one can be found after it's gone
+    for(auto it = c.entries.begin(); it != c.entries.end();)
+    {
+        if(it->first.first != context)
+        {
+            it++;
+            continue;
+        }
+
+        c.bytes -= it->second.bytes;
+        it = c.entries.erase(it);
+    }
+
+    for(auto it = c.paths.begin(); it != c.paths.end();)
+        it = it->first.first == context ? c.paths.erase(it) : std::next(it);
+
+    for(auto it = c.hashes.begin(); it != c.hashes.end();)
+        it = it->first.first == context ? c.hashes.erase(it) : std::next(it);
+}
+
+size_t TextureCache::get_memory_usage()
+{
+    std::lock_guard<std::mutex> lock(cache().mutex);
+    return cache().bytes;
+}
+
+size_t TextureCache::get_texture_count()
+{
+    std::lock_guard<std::mutex> lock(cache().mutex);
+    return cache().entries.size();
+}
+
+END_NAMESPACE
@@ -1,13 +1,23 @@
 #include "../../include/utils/color.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define GFX_COLOR_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define GFX_COLOR_NEON
+#endif
+
 START_NAMESPACE
 
+// The channels are promoted to int, so adding
+// and subtracting can't overflow
 Color& Color::operator+(const Color& rhs)
 {
-    r = ((r + rhs.r) >= MAX_COLORS) ? MAX_COLORS : (r + rhs.r);
-    g = ((g + rhs.r) >= MAX_COLORS) ? MAX_COLORS : (g + rhs.g);
-    b = ((b + rhs.b) >= MAX_COLORS) ? MAX_COLORS : (b + rhs.b);
-    a = ((a + rhs.a) >= MAX_COLORS) ? MAX_COLORS : (a + rhs.a);
+    r = clamp(r + rhs.r);
+    g = clamp(g + rhs.g);
+    b = clamp(b + rhs.b);
+    a = clamp(a + rhs.a);
     
     return *this;
 }   
@@ -15,7 +25,7 @@ Color& Color::operator+(const Color& rhs)
 Color& Color::operator-(const Color& rhs) 
 {
     r = ((r - rhs.r) <= 0) ? 0 : (r - rhs.r);
-    g = ((g - rhs.r) <= 0) ? 0 : (g - rhs.g);
+    g = ((g - rhs.g) <= 0) ? 0 : (g - rhs.g);
     b = ((b - rhs.b) <= 0) ? 0 : (b - rhs.b);
     a = ((a - rhs.a) <= 0) ? 0 : (a - rhs.a);
 
@@ -24,10 +34,10 @@ Color& Color::operator-(const Color& rhs)
 
 Color& Color::operator+=(const Color& rhs)
 {
-    r = ((r + rhs.r) >= MAX_COLORS) ? MAX_COLORS : (r + rhs.r);
-    g = ((g + rhs.r) >= MAX_COLORS) ? MAX_COLORS : (g + rhs.g);
-    b = ((b + rhs.b) >= MAX_COLORS) ? MAX_COLORS : (b + rhs.b);
-    a = ((a + rhs.a) >= MAX_COLORS) ? MAX_COLORS : (a + rhs.a);
+    r = clamp(r + rhs.r);
+    g = clamp(g + rhs.g);
+    b = clamp(b + rhs.b);
+    a = clamp(a + rhs.a);
     
     return *this;
 }   
@@ -35,7 +45,7 @@ Color& Color::operator+=(const Color& rhs)
 Color& Color::operator-=(const Color& rhs)
 {
     r = ((r - rhs.r) <= 0) ? 0 : (r - rhs.r);
-    g = ((g - rhs.r) <= 0) ? 0 : (g - rhs.g);
+    g = ((g - rhs.g) <= 0) ? 0 : (g - rhs.g);
     b = ((b - rhs.b) <= 0) ? 0 : (b - rhs.b);
     a = ((a - rhs.a) <= 0) ? 0 : (a - rhs.a);
     
@@ -52,4 +62,110 @@ Color& Color::operator=(const Color& color)
     return *this;   
 }
 
+// ------------------------------------------------------------ //
+
+void colors_to_gl(const Color* colors, float* out, size_t count)
+{
+    size_t i = 0;
+
+#if defined(GFX_COLOR_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(1.f / 255.f);
+
+    // 4 colors are 16 bytes, every byte becomes a float
+    for(; i + 4 <= count; i += 4)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + i));
+        const __m128i low   = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i high  = _mm_unpackhi_epi8(bytes, zero);
+
+        float* dst = out + i * 4;
+        _mm_storeu_ps(dst,      _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low,  zero)), scale));
+        _mm_storeu_ps(dst + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low,  zero)), scale));
+        _mm_storeu_ps(dst + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+        _mm_storeu_ps(dst + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+    }
+#elif defined(GFX_COLOR_NEON)
+    for(; i + 4 <= count; i += 4)
+    {
+        const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(colors + i));
+        const uint16x8_t low   = vmovl_u8(vget_low_u8(bytes));
+        const uint16x8_t high  = vmovl_u8(vget_high_u8(bytes));
+
+        float* dst = out + i * 4;
+        vst1q_f32(dst,      vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))),   1.f / 255.f));
+        vst1q_f32(dst + 4,  vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))),  1.f / 255.f));
+        vst1q_f32(dst + 8,  vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))),  1.f / 255.f));
+        vst1q_f32(dst + 12, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), 1.f / 255.f));
+    }
+#endif
+
+    // The rest of the colors
+    for(; i < count; i++)
+    {
+        out[i * 4 + 0] = rgba_to_gl(colors[i].r);
+        out[i * 4 + 1] = rgba_to_gl(colors[i].g);
+        out[i * 4 + 2] = rgba_to_gl(colors[i].b);
+        out[i * 4 + 3] = rgba_to_gl(colors[i].a);
+    }
+}
+
+// ------------------------------------------------------------ //
+
+// Clamping a single float between 0 and 1 and rounding it to a byte
+static unsigned char gl_to_byte(float color)
+{
+    color = color < 0.f ? 0.f : (color > 1.f ? 1.f : color);
+    return static_cast<unsigned char>(color * 255.f + 0.5f);
+}
+
+void gl_to_colors(const float* colors, Color* out, size_t count)
+{
+    size_t i = 0;
+
+#if defined(GFX_COLOR_SSE2)
+    const __m128 zero  = _mm_setzero_ps();
+    const __m128 one   = _mm_set1_ps(1.f);
+    const __m128 scale = _mm_set1_ps(255.f);
+    const __m128 half  = _mm_set1_ps(0.5f);
+
+    auto convert = [&](const float* src) {
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), zero), one);
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, scale), half));
+    };
+
+    // 16 floats are packed into 16 bytes, the values are
+    // already between 0 and 255 so packing can't saturate
+    for(; i + 4 <= count; i += 4)
+    {
+        const float* src = colors + i * 4;
+        const __m128i low  = _mm_packs_epi32(convert(src),     convert(src + 4));
+        const __m128i high = _mm_packs_epi32(convert(src + 8), convert(src + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, high));
+    }
+#elif defined(GFX_COLOR_NEON)
+    auto convert = [](const float* src) {
+        const float32x4_t clamped = vminq_f32(vmaxq_f32(vld1q_f32(src), vdupq_n_f32(0.f)), vdupq_n_f32(1.f));
+        return vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(0.5f), clamped, 255.f)));
+    };
+
+    for(; i + 4 <= count; i += 4)
+    {
+        const float* src = colors + i * 4;
+        const uint16x8_t low  = vcombine_u16(convert(src),     convert(src + 4));
+        const uint16x8_t high = vcombine_u16(convert(src + 8), convert(src + 12));
+        vst1q_u8(reinterpret_cast<uint8_t*>(out + i), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+    }
+#endif
+
+    // The rest of the colors
+    for(; i < count; i++)
+    {
+        out[i].r = gl_to_byte(colors[i * 4 + 0]);
+        out[i].g = gl_to_byte(colors[i * 4 + 1]);
+        out[i].b = gl_to_byte(colors[i * 4 + 2]);
+        out[i].a = gl_to_byte(colors[i * 4 + 3]);
+    }
+}
+
 END_NAMESPACE
\ No newline at end of file
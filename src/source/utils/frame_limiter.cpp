@@ -0,0 +1,145 @@
+#include "../../include/utils/frame_limiter.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <time.h>
+#include <cerrno>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+START_NAMESPACE
+
+// The limits of the spinning time
+static constexpr int64_t MIN_SPIN = 50000;
+static constexpr int64_t MAX_SPIN = 4000000;
+
+// ------------------------------------------------------------ //
+
+FrameLimiter::FrameLimiter()
+    : m_target(0.0), m_period(0), m_deadline(0), m_last_late(0), m_spin(1000000) {}
+
+// ------------------------------------------------------------ //
+
+void FrameLimiter::set_target(double fps)
+{
+    m_target = fps > 0.0 ? fps : 0.0;
+    m_period = fps > 0.0 ? static_cast<int64_t>(1e9 / fps) : 0;
+
+    // The first frame after a change is never late
+    m_deadline = 0;
+}
+
+double FrameLimiter::get_target() const {
+    return m_target;
+}
+
+// ------------------------------------------------------------ //
+
+bool FrameLimiter::advance()
+{
+    m_last_late = 0;
+    const int64_t current = now();
+
+    // Every frame is due right away without a target
+    if(m_period == 0)
+    {
+        m_deadline = current;
+        return true;
+    }
+
+    if(m_deadline == 0)
+        m_deadline = current;
+
+    // The deadlines are following each other, so a
+    // frame that was a bit early is not drifting
+    m_deadline += m_period;
+
+    if(current > m_deadline)
+    {
+        // Not trying to catch up with the frames that were lost
+        m_last_late = current - m_deadline;
+        m_deadline = current;
+        return false;
+    }
+
+    return true;
+}
+
+bool FrameLimiter::wait()
+{
+    if(!advance())
+        return false;
+
+    if(m_period == 0)
+        return true;
+
+    const int64_t current = now();
+    if(m_deadline - current > m_spin)
+    {
+        const int64_t target = m_deadline - m_spin;
+        sleep_until(target);
+
+        // Waking up too late has to be covered by spinning
+        // next time, waking up on time lets it shrink slowly
+        const int64_t overshoot = now() - target;
+        m_spin = std::max(overshoot + overshoot / 2, m_spin - m_spin / 64);
+        m_spin = std::min(std::max(m_spin, MIN_SPIN), MAX_SPIN);
+    }
+
+    while(now() < m_deadline)
+        ;
+
+    return true;
+}
+
+int64_t FrameLimiter::get_deadline() const {
+    return m_deadline;
+}
+
+double FrameLimiter::get_last_late_ms() const {
+    return m_last_late / 1e6;
+}
+
+// ------------------------------------------------------------ //
+
+#ifdef __linux__
+
+int64_t FrameLimiter::now()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+void FrameLimiter::sleep_until(int64_t time)
+{
+    timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(time / 1000000000);
+    deadline.tv_nsec = static_cast<long>(time % 1000000000);
+
+    // An absolute time is not drifting when a signal interrupts it
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+        ;
+}
+
+#else
+
+int64_t FrameLimiter::now()
+{
+    using namespace std::chrono;
+    return static_cast<int64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void FrameLimiter::sleep_until(int64_t time)
+{
+    const int64_t left = time - now();
+    if(left > 0)
+        std::this_thread::sleep_for(std::chrono::nanoseconds(left));
+}
+
+#endif
+
+END_NAMESPACE
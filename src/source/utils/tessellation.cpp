@@ -0,0 +1,90 @@
+#include "../../include/utils/tessellation.hpp"
+
+#include <vector>
+#include <cmath>
+
+START_NAMESPACE
+
+// Every amount of segments that has a table,
+// sorted from the smallest to the biggest
+static constexpr int BUCKETS[] = { 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+static constexpr int BUCKETS_SIZE = sizeof(BUCKETS) / sizeof(BUCKETS[0]);
+
+// Maximum distance in pixels between a segment and the real circle
+static constexpr float TOLERANCE = 0.25f;
+
+// Returns the index of the smallest bucket that has
+// at least the requested amount of segments
+static int bucket_of(int segments)
+{
+    for(int i = 0; i < BUCKETS_SIZE; i++)
+    {
+        if(BUCKETS[i] >= segments)
+            return i;
+    }
+
+    return BUCKETS_SIZE - 1;
+}
+
+// Building all of the tables once, static locals are
+// initialized in a thread safe way, so every window
+// thread can use them
+static const std::vector<std::vector<VectorF>>& tables()
+{
+    static const std::vector<std::vector<VectorF>> tables_ = []() {
+        std::vector<std::vector<VectorF>> result(BUCKETS_SIZE);
+
+        for(int i = 0; i < BUCKETS_SIZE; i++)
+        {
+            const int segments = BUCKETS[i];
+            result[i].reserve(segments + 1);
+
+            for(int j = 0; j < segments; j++)
+            {
+                const float theta = PI2 * j / segments;
+                result[i].push_back(VectorF(cosf(theta), sinf(theta)));
+            }
+
+            // Closing the circle
+            result[i].push_back(result[i].front());
+        }
+
+        return result;
+    }();
+
+    return tables_;
+}
+
+// ------------------------------------------------------------ //
+
+int Tessellation::segments(float radius)
+{
+    radius = std::fabs(radius);
+    if(radius <= TOLERANCE)
+        return MIN_SEGMENTS;
+
+    // The sagitta of every segment has to be smaller than the tolerance:
+    // r * (1 - cos(theta / 2)) <= tolerance
+    const float half_angle = std::acos(1.f - TOLERANCE / radius);
+    const int needed = static_cast<int>(std::ceil(PI / half_angle));
+
+    return BUCKETS[bucket_of(needed)];
+}
+
+int Tessellation::segments(float radius, const VectorF& scale)
+{
+    const float biggest = std::fabs(scale.x) > std::fabs(scale.y) ? std::fabs(scale.x) : std::fabs(scale.y);
+    return segments(radius * biggest);
+}
+
+int Tessellation::segments(float radius, const Matrix& matrix) {
+    return segments(radius * matrix.max_scale());
+}
+
+// ------------------------------------------------------------ //
+
+const VectorF* Tessellation::unit_circle(int segments) {
+    return tables()[bucket_of(segments)].data();
+}
+
+END_NAMESPACE
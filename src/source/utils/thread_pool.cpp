@@ -0,0 +1,64 @@
+#include "../../include/utils/thread_pool.hpp"
+
+START_NAMESPACE
+
+ThreadPool::ThreadPool(size_t workers)
+    : m_stopping(false)
+{
+    if(workers == 0)
+        workers = 1;
+
+    for(size_t i = 0; i < workers; i++)
+        m_workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for(auto& worker : m_workers)
+        worker.join();
+}
+
+// ------------------------------------------------------------ //
+
+size_t ThreadPool::get_worker_count() const noexcept {
+    return m_workers.size();
+}
+
+size_t ThreadPool::hardware_workers() noexcept
+{
+    // It's allowed to return 0 if it's unknown
+    const unsigned int count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+// ------------------------------------------------------------ //
+
+void ThreadPool::work()
+{
+    while(true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            // Stopping only after the queue is empty
+            if(m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
+
+END_NAMESPACE
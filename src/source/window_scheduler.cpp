@@ -0,0 +1,155 @@
+#include "../include/window_scheduler.hpp"
+#include "../include/profiler.hpp"
+
+#include <thread>
+#include <chrono>
+#include <utility>
+
+START_NAMESPACE
+
+WindowScheduler::WindowScheduler(size_t workers)
+    : m_remaining(0), m_frames(0)
+{
+#ifdef _WIN32
+    workers = 1;
+#endif
+    m_workers = workers > 0 ? workers : 1;
+}
+
+// ------------------------------------------------------------ //
+
+void WindowScheduler::add_window(std::function<Window()> create)
+{
+    std::unique_ptr<Task> task(new Task{ std::move(create), Window(nullptr, nullptr), 0, false, false });
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+}
+
+void WindowScheduler::run()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_remaining = m_tasks.size();
+    }
+
+    // The calling thread is the last worker
+    std::vector<std::thread> workers;
+    for(size_t i = 1; i < m_workers; i++)
+        workers.emplace_back(&WindowScheduler::work, this);
+
+    work();
+
+    for(auto& worker : workers)
+        worker.join();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.clear();
+        std::swap(error, m_error);
+    }
+
+    if(error)
+        std::rethrow_exception(error);
+}
+
+// ------------------------------------------------------------ //
+
+size_t WindowScheduler::get_worker_count() const {
+    return m_workers;
+}
+
+unsigned long WindowScheduler::get_frames() const {
+    return m_frames.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------ //
+
+void WindowScheduler::work()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(m_remaining > 0)
+    {
+        // The earliest deadline first, windows without a target
+        // are due when their last frame ended so they take turns
+        Task* next = nullptr;
+        for(auto& task : m_tasks)
+        {
+            if(!task->busy && !task->done && (!next || task->due < next->due))
+                next = task.get();
+        }
+
+        // Every window is running on another worker
+        if(!next)
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        // Another window may be due before it when it's done
+        const int64_t current = FrameLimiter::now();
+        if(next->due > current)
+        {
+            m_condition.wait_for(lock, std::chrono::nanoseconds(next->due - current));
+            continue;
+        }
+
+        next->busy = true;
+        lock.unlock();
+
+        // An exception cannot leave a worker thread, the window is
+        // destroyed here while its context is still current
+        bool running = false;
+        std::exception_ptr error;
+        try {
+            running = run_frame(*next);
+        }
+        catch(...) {
+            error = std::current_exception();
+            next->window.reset();
+        }
+
+        lock.lock();
+        next->busy = false;
+        if(!running)
+        {
+            next->done = true;
+            m_remaining--;
+        }
+
+        if(error && !m_error)
+            m_error = error;
+
+        m_condition.notify_all();
+    }
+}
+
+bool WindowScheduler::run_frame(Task& task)
+{
+    // The window is created on the worker that runs its first
+    // frame, its context is already current after that
+    if(!task.window)
+        task.window = task.create();
+    else
+        task.window->make_current();
+
+    // The window is destroyed while its context is current
+    if(!task.window->is_running())
+    {
+        task.window.reset();
+        return false;
+    }
+
+    {
+        GFX_PROFILE_ZONE("on_update");
+        task.window->on_update();
+    }
+
+    task.due = task.window->schedule_next_frame();
+    task.window->release_current();
+
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+END_NAMESPACE
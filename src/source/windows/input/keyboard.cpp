@@ -1,7 +1,15 @@
 #include "../../../include/windows/input/keyboard.hpp"
+#include "../../../include/windows/renderer.hpp"
 
 START_NAMESPACE
 
+// The highest bit is set while the key is down
+static bool is_set(const BYTE* keys, unsigned int key) {
+    return (keys[key & 0xFF] & 0x80) != 0;
+}
+
+// ------------------------------------------------------------ //
+
 bool Keyboard::key_pressed(unsigned int key)
 {
     return GetKeyState(key) & 0x8000;
@@ -12,4 +20,30 @@ bool Keyboard::key_pressed(Key key)
     return key_pressed(static_cast<unsigned int>(key));
 }
 
+// ------------------------------------------------------------ //
+
+bool Keyboard::key_pressed(Renderer& renderer, Key key) {
+    return key_pressed(renderer, static_cast<unsigned int>(key));
+}
+
+bool Keyboard::key_pressed(Renderer& renderer, unsigned int key) {
+    return is_set(renderer.keymap, key);
+}
+
+bool Keyboard::key_down(Renderer& renderer, Key key) {
+    return key_down(renderer, static_cast<unsigned int>(key));
+}
+
+bool Keyboard::key_down(Renderer& renderer, unsigned int key) {
+    return is_set(renderer.keymap, key) && !is_set(renderer.last_keymap, key);
+}
+
+bool Keyboard::key_released(Renderer& renderer, Key key) {
+    return key_released(renderer, static_cast<unsigned int>(key));
+}
+
+bool Keyboard::key_released(Renderer& renderer, unsigned int key) {
+    return !is_set(renderer.keymap, key) && is_set(renderer.last_keymap, key);
+}
+
 END_NAMESPACE
\ No newline at end of file
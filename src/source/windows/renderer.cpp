@@ -1,34 +1,54 @@
 #include "../../include/windows/renderer.hpp"
+#include "../../include/profiler.hpp"
+#include "../../include/texture_cache.hpp"
 
 #include <gl/GL.h> 
 #include <gl/GLU.h> 
 
 #include <string>
+#include <cstring>
 
 #define WINDOW_CLASS_NAME L"Window"
 
 START_NAMESPACE
 
 Renderer::Renderer(const Geometry& geometry)
-{
-    /*Parent*/ m_geometry = geometry;
-    create();
-}
+    : Renderer(geometry, Backend::OpenGL) {}
 
 Renderer::Renderer(unsigned int width, unsigned int height)
+    : Renderer(Geometry(width, height), Backend::OpenGL) {}
+
+Renderer::Renderer(unsigned int width, unsigned int height, Backend backend)
+    : Renderer(Geometry(width, height), backend) {}
+
+Renderer::Renderer(const Geometry& geometry, Backend backend)
+    : Renderer(geometry, backend, nullptr) {}
+
+Renderer::Renderer(unsigned int width, unsigned int height, Backend backend, ShareGroup* group)
+    : Renderer(Geometry(width, height), backend, group) {}
+
+Renderer::Renderer(const Geometry& geometry, Backend backend, ShareGroup* group)
+    : share_group(group)
 {
-    /*Parent*/ m_geometry = {width, height};
-    create();
+    /*Parent*/ m_geometry = geometry;
+    create(backend);
 }
 
 Renderer::~Renderer()
 {
+    // The queries have to be deleted while the context is still
+    // alive, the parent is destroyed only after it's gone
+    /*Parent*/ m_gpu_timer.reset();
+
     // Clean up the window registers
     if (class_registered)
     {
         UnregisterClassW(WINDOW_CLASS_NAME, instance);
         class_registered = false;
     }
+
+    if(/*Parent*/ m_software)
+        SoftwareRasterizer::make_current(nullptr);
 }
 
 // ------------------------------------------------------------ //
@@ -41,12 +61,15 @@ Renderer& Renderer::get_renderer() /*override*/ {
 
 void Renderer::set_title(const std::string& title) /*override*/
 {
+    /*Parent*/ m_title = title;
+
+    if(!m_hwnd)
+        return;
+
     std::wstring converted_title(title.begin(), title.end());
 
     // SetWindowText is expecting wide characters string
     SetWindowText(m_hwnd, converted_title.c_str());
-
-    /*Parent*/ m_title = title;
 }
 
 // ------------------------------------------------------------ //
@@ -54,24 +77,171 @@ void Renderer::set_title(const std::string& title) /*override*/
 bool Renderer::is_running() /*override*/
 {
     /*Parent*/ start_ticks = std::chrono::high_resolution_clock::now();
-    return handle_events();
+    /*Parent*/ run_posted();
+
+    // There are no messages without a window
+    if(/*Parent*/ m_headless)
+        return /*Parent*/ running;
+
+    const bool result = handle_events();
+
+    // Fetching the state of every key once for the whole frame
+    std::memcpy(last_keymap, keymap, sizeof(keymap));
+    GetKeyboardState(keymap);
+
+    return result;
 }
 
 // ------------------------------------------------------------ //
 
 void Renderer::swap_buffers() /*override*/
 {
+    GFX_PROFILE_ZONE("swap buffers");
+
+    // Submitting everything that was drawn in batched mode
+    /*Parent*/ flush_batch();
+
+    if(/*Parent*/ m_gpu_timer)
+        /*Parent*/ m_gpu_timer->end_frame();
+
+    // Nothing is displayed, the frame is only kept
+    if(/*Parent*/ m_headless)
+        /*Parent*/ capture_frame();
+    else
+    {
+        HDC hdc = GetDC(m_hwnd);
+        if(/*Parent*/ m_software)
+            present_software(hdc);
+        else
+            SwapBuffers(hdc);
+        ReleaseDC(m_hwnd, hdc);
+    }
+
+    // WGL has no way of counting the vertical blanks
+    /*Parent*/ record_swap(-1);
+}
+
+// ------------------------------------------------------------ //
+
+bool Renderer::set_swap_interval(int interval) /*override*/
+{
+    if(!swap_interval_ext || (interval < 0 && !adaptive_swap))
+        return false;
+
+    if(!swap_interval_ext(interval))
+        return false;
+
+    /*Parent*/ m_frame_stats.swap_interval = get_swap_interval_ext ? get_swap_interval_ext() : interval;
+    return true;
+}
+
+void Renderer::present_software(HDC hdc) noexcept
+{
+    // Windows is expecting BGRX pixels
+    const Color* pixels = /*Parent*/ m_software->get_pixels();
+    for(size_t i = 0; i < image_pixels.size(); i++)
+        image_pixels[i] = pixels[i].b | (pixels[i].g << 8) | (pixels[i].r << 16);
+
+    // A negative height is a top down image
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = m_geometry.width;
+    info.bmiHeader.biHeight = -static_cast<LONG>(m_geometry.height);
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    SetDIBitsToDevice(
+        hdc, 
+        0, 0, m_geometry.width, m_geometry.height, 
+        0, 0, 0, m_geometry.height, 
+        image_pixels.data(), &info, DIB_RGB_COLORS);
+}
+
+// ------------------------------------------------------------ //
+
+void Renderer::make_current() /*override*/
+{
+    if(/*Parent*/ m_software)
+    {
+        SoftwareRasterizer::make_current(m_software.get());
+        return;
+    }
+
     HDC hdc = GetDC(m_hwnd);
-    SwapBuffers(hdc);
+    wglMakeCurrent(hdc, opengl_context);
     ReleaseDC(m_hwnd, hdc);
 }
 
+void Renderer::release_current() /*override*/
+{
+    if(/*Parent*/ m_software)
+        SoftwareRasterizer::make_current(nullptr);
+    else
+        wglMakeCurrent(nullptr, nullptr);
+}
+
 // ------------------------------------------------------------ //
 
-void Renderer::create()
+void Renderer::create(Backend backend)
 {
-    init_members();
-    
+    // No key is pressed before the first frame
+    std::memset(keymap, 0, sizeof(keymap));
+    std::memset(last_keymap, 0, sizeof(last_keymap));
+
+    // There is no offscreen context without a window
+    // on Windows, so headless windows are always
+    // drawn with the software rasterizer
+    const bool headless = backend == Backend::Headless || backend == Backend::HeadlessSoftware;
+    if(headless)
+    {
+        /*Parent*/ m_headless = true;
+        m_hwnd = nullptr;
+        class_registered = false;
+    }
+    else
+        init_members();
+
+    // The OpenGL context is still created by the window,
+    // but nothing is drawn with it
+    if(backend != Backend::OpenGL)
+    {
+        if(!headless)
+            image_pixels.resize(static_cast<size_t>(m_geometry.width) * m_geometry.height);
+
+        /*Parent*/ m_software.reset(new SoftwareRasterizer(m_geometry));
+        SoftwareRasterizer::make_current(m_software.get());
+    }
+
+    // The window made its context current when it was created
+    opengl_context = headless ? nullptr : wglGetCurrentContext();
+
+    // A context cannot be current while it's joining the other
+    // contexts of the group, and it must not have any textures yet
+    if(share_group && opengl_context && backend == Backend::OpenGL)
+    {
+        void* share = nullptr;
+        bool joined = share_group->begin_join(ShareGroup::Api::WGL, share);
+
+        if(joined && share)
+        {
+            HDC hdc = GetDC(m_hwnd);
+            wglMakeCurrent(nullptr, nullptr);
+            joined = wglShareLists(static_cast<HGLRC>(share), opengl_context) != FALSE;
+            wglMakeCurrent(hdc, opengl_context);
+            ReleaseDC(m_hwnd, hdc);
+        }
+
+        share_group->end_join(joined ? opengl_context : nullptr);
+    }
+
+    swap_interval_ext = nullptr;
+    get_swap_interval_ext = nullptr;
+    adaptive_swap = false;
+
+    if(backend == Backend::OpenGL)
+        init_swap_control();
+
     /*Parent*/ running = true;
 }
 
@@ -136,9 +306,24 @@ LRESULT CALLBACK Renderer::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lP
         break;
     // ON CLOSE it's quiting the window
     case WM_CLOSE:
+    {
+        // The other windows of the group are not sharing with it anymore,
+        // and the cache cannot find the textures of the context after it
+        Renderer* renderer = reinterpret_cast<Renderer*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
+
+        // Same as the destructor, the context is deleted right below
+        if(renderer)
+            renderer->m_gpu_timer.reset();
+
+        if(renderer && renderer->share_group)
+            renderer->share_group->leave(wglGetCurrentContext());
+        else
+            TextureCache::drop_context(wglGetCurrentContext());
+
         wglDeleteContext(wglGetCurrentContext());
         PostQuitMessage(0);
         break;
+    }
     // ON STARTUP it's creating an OpenGL context
     case WM_CREATE:
         create_opengl_context(hWnd);
@@ -197,6 +382,28 @@ void Renderer::create_opengl_context(HWND hWnd) noexcept
     std::cout << "[WINDOWS] GL Version: " << glGetString(GL_VERSION) << std::endl;
 }
 
+void Renderer::init_swap_control() noexcept
+{
+    typedef const char* (WINAPI* GetExtensionsString)();
+    auto get_extensions = reinterpret_cast<GetExtensionsString>(wglGetProcAddress("wglGetExtensionsStringEXT"));
+    if(!get_extensions)
+        return;
+
+    const std::string extensions = std::string(" ") + get_extensions() + " ";
+    if(extensions.find(" WGL_EXT_swap_control ") == std::string::npos)
+        return;
+
+    swap_interval_ext = reinterpret_cast<BOOL (WINAPI*)(int)>(wglGetProcAddress("wglSwapIntervalEXT"));
+    get_swap_interval_ext = reinterpret_cast<int (WINAPI*)()>(wglGetProcAddress("wglGetSwapIntervalEXT"));
+    adaptive_swap = extensions.find(" WGL_EXT_swap_control_tear ") != std::string::npos;
+
+    if(swap_interval_ext)
+    {
+        /*Parent*/ m_swap_control = "WGL_EXT_swap_control";
+        /*Parent*/ m_frame_stats.swap_interval = get_swap_interval_ext ? get_swap_interval_ext() : 1;
+    }
+}
+
 // ------------------------------------------------------------ //
 
 void CALLBACK Renderer::force_update() {
@@ -205,6 +412,8 @@ void CALLBACK Renderer::force_update() {
 
 bool Renderer::handle_events() noexcept
 {
+    GFX_PROFILE_ZONE("handle events");
+
     // Extracting the message from the message handler
     // Right into this class memory so i can use it later
     // from other places
@@ -217,6 +426,9 @@ bool Renderer::handle_events() noexcept
             // Call the unused update function every 1 miliseconds
             SetTimer(m_hwnd, 0, 1, reinterpret_cast<TIMERPROC>(&force_update));
 
+            // Keeping the input for the user
+            handle_input(msg);
+
             // Translate virtual keys and send the message
             // to the window procedure
             TranslateMessage(&msg);
@@ -237,4 +449,61 @@ bool Renderer::handle_events() noexcept
     return false;
 }
 
-END_NAMESPACE
+// ------------------------------------------------------------ //
+
+void Renderer::handle_input(const MSG& message) noexcept
+{
+    // The mouse position is in the low and high words,
+    // except the scroll wheel that is using the screen position
+    POINT point = { static_cast<short>(LOWORD(message.lParam)), static_cast<short>(HIWORD(message.lParam)) };
+    if(message.message == WM_MOUSEWHEEL || message.message == WM_MOUSEHWHEEL)
+        ScreenToClient(m_hwnd, &point);
+
+    const VectorI position(point.x, point.y);
+
+    switch(message.message)
+    {
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN:
+    {
+        // The 30th bit is set if the key was already down
+        InputEvent event(InputEvent::Type::KeyPressed, static_cast<unsigned int>(message.wParam), {0, 0});
+        event.repeat = (message.lParam & (1 << 30)) != 0;
+        /*Parent*/ push_event(event);
+        break;
+    }
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+        /*Parent*/ push_event(InputEvent(InputEvent::Type::KeyReleased, static_cast<unsigned int>(message.wParam), {0, 0}));
+        break;
+
+    // Same values as Mouse::Button
+    case WM_LBUTTONDOWN: /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonPressed,  1, position)); break;
+    case WM_MBUTTONDOWN: /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonPressed,  2, position)); break;
+    case WM_RBUTTONDOWN: /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonPressed,  3, position)); break;
+    case WM_LBUTTONUP:   /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonReleased, 1, position)); break;
+    case WM_MBUTTONUP:   /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonReleased, 2, position)); break;
+    case WM_RBUTTONUP:   /*Parent*/ push_event(InputEvent(InputEvent::Type::ButtonReleased, 3, position)); break;
+
+    case WM_MOUSEWHEEL:
+    case WM_MOUSEHWHEEL:
+    {
+        const int steps = GET_WHEEL_DELTA_WPARAM(message.wParam) / WHEEL_DELTA;
+        const bool vertical = message.message == WM_MOUSEWHEEL;
+
+        InputEvent event(InputEvent::Type::Scroll, vertical ? (steps > 0 ? 4 : 5) : (steps > 0 ? 7 : 6), position);
+        if(vertical)
+            event.scroll.y = steps;
+        else
+            event.scroll.x = steps;
+        /*Parent*/ push_event(event);
+        break;
+    }
+
+    case WM_MOUSEMOVE:
+        /*Parent*/ push_event(InputEvent(InputEvent::Type::Motion, 0, position));
+        break;
+    }
+}
+
+END_NAMESPACE
\ No newline at end of file